@@ -6,4 +6,4 @@ AUTHOR  := Zakhary Kaplan <zakharykaplan@gmail.com>
 # Build
 CONFIG   := DEFAULT
 CXXFLAGS := -Wall -g -std=c++2a
-LDLIBS   := -lfmt
+LDLIBS   := -lfmt -pthread
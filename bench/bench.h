@@ -0,0 +1,93 @@
+//
+//  bench.h
+//  Benchmark harness.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../test/hooks.h"
+
+// NOTE: includes the global allocation hooks, so this header must be included by exactly one
+//       translation unit per benchmark binary.
+
+namespace bench {
+
+using hooks::allocs;
+using hooks::Argv;
+using hooks::bytes;
+
+// Peak resident set size (in kilobytes)
+inline long peakRss() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Measure `body(setup())` over `n` units of work.
+//
+// Each iteration gets a fresh state from `setup`, which is excluded from timing and allocation
+// counts. Iterations repeat until enough time has elapsed for a stable reading; the fastest
+// iteration is reported.
+template <typename Setup, typename Body>
+void run(const char *name, const char *unit, std::size_t n, Setup setup, Body body) {
+    using clock = std::chrono::steady_clock;
+    const auto budget = std::chrono::milliseconds(200);
+
+    double best = -1;
+    std::size_t nallocs = 0, nbytes = 0;
+    auto elapsed = clock::duration::zero();
+    for (int iter = 0; iter < 1000 && (iter < 3 || elapsed < budget); iter++) {
+        auto state = setup();
+        // Time this iteration
+        std::size_t allocs0 = allocs, bytes0 = bytes;
+        auto start = clock::now();
+        body(state);
+        auto stop = clock::now();
+        std::size_t dallocs = allocs - allocs0, dbytes = bytes - bytes0;
+        // Record fastest iteration
+        double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+        if (best < 0 || ns < best) {
+            best = ns;
+            nallocs = dallocs;
+            nbytes = dbytes;
+        }
+        elapsed += stop - start;
+    }
+
+    // Print human-readable result
+    std::fprintf(stderr,
+                 "%-24s n=%-8zu %12.2f ns/%-6s %10zu allocs %12zu bytes\n",
+                 name,
+                 n,
+                 best / n,
+                 unit,
+                 nallocs,
+                 nbytes);
+    // Print machine-readable result
+    std::printf("{\"bench\":\"%s\",\"version\":\"%s\",\"n\":%zu,\"unit\":\"%s\","
+                "\"ns_per_unit\":%.3f,\"ns_total\":%.0f,\"allocs\":%zu,\"bytes\":%zu,"
+                "\"peak_rss_kb\":%ld}\n",
+                name,
+                std::getenv("CLIP_BENCH_VERSION") ? std::getenv("CLIP_BENCH_VERSION") : "",
+                n,
+                unit,
+                best / n,
+                best,
+                nallocs,
+                nbytes,
+                peakRss());
+}
+
+} // namespace bench
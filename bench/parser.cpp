@@ -0,0 +1,624 @@
+//
+//  parser.cpp
+//  Parser benchmarks.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "clip/clip.h"
+
+using namespace std;
+
+namespace {
+
+// Schema used by the parse benchmarks
+constexpr size_t NOPTS = 64;
+constexpr size_t NFLAGS = 6;
+constexpr size_t NARGS = 4;
+
+vector<string> names(const char *prefix, size_t n) {
+    vector<string> v;
+    for (size_t i = 0; i < n; i++)
+        v.push_back(prefix + to_string(i));
+    return v;
+}
+
+unique_ptr<clip::Parser> schema(bench::Argv &argv) {
+    auto parser = make_unique<clip::Parser>(argv.argc(), argv.argv(), clip::App("bench"));
+    static const auto opts = names("opt", NOPTS);
+    static const auto flags = names("flag", NFLAGS);
+    static const auto args = names("arg", NARGS);
+    for (const auto &name : opts)
+        parser->add(clip::Opt<int>(name.data()).help("Sample integer."));
+    for (size_t i = 0; i < flags.size(); i++)
+        parser->add(clip::Flag(flags[i].data()).shortname('a' + i).help("Sample flag."));
+    parser->add(clip::Opt<int>("num").shortname('n').help("Sample short integer."));
+    parser->add(clip::Opt<string>("str").shortname('s').help("Sample short string."));
+    for (const auto &name : args)
+        parser->add(clip::Arg<int>(name.data()).help("Sample positional."));
+    return parser;
+}
+
+// Compile-time equivalent of `schema()` (without the 64 long options)
+constexpr auto STATIC = clip::schema([] {
+    return std::array{
+        clip::Spec::flag("flag0").shortname('a').help("Sample flag."),
+        clip::Spec::flag("flag1").shortname('b').help("Sample flag."),
+        clip::Spec::flag("flag2").shortname('c').help("Sample flag."),
+        clip::Spec::flag("flag3").shortname('d').help("Sample flag."),
+        clip::Spec::flag("flag4").shortname('e').help("Sample flag."),
+        clip::Spec::flag("flag5").shortname('f').help("Sample flag."),
+        clip::Spec::opt<int>("num").shortname('n').help("Sample short integer."),
+        clip::Spec::opt("str").shortname('s').help("Sample short string."),
+        clip::Spec::arg<int>("arg0").help("Sample positional."),
+        clip::Spec::arg<int>("arg1").help("Sample positional."),
+        clip::Spec::arg<int>("arg2").help("Sample positional."),
+        clip::Spec::arg<int>("arg3").help("Sample positional."),
+    };
+});
+
+// Synthetic argv of exactly `n` tokens mixing every supported form
+bench::Argv mixed(size_t n) {
+    bench::Argv argv;
+    size_t count = 0;
+    // Positional arguments
+    for (size_t i = 0; i < NARGS && count < n; i++, count++)
+        argv.push(to_string(i));
+    // Options
+    for (size_t i = 0; count < n; i++) {
+        string opt = "opt" + to_string(i % NOPTS);
+        string flag = "flag" + to_string(i % NFLAGS);
+        bool pair = count + 2 <= n; // room for a two-token form
+        switch (i % 8) {
+            case 0: argv.push("--" + opt + "=42"), count++; break;
+            case 1:
+                if (pair)
+                    argv.push("--" + opt).push("42"), count += 2;
+                else
+                    argv.push("--" + flag), count++;
+                break;
+            case 2: argv.push("-a"), count++; break;
+            case 3: argv.push("-bcd"), count++; break;
+            case 4: argv.push("-n7"), count++; break;
+            case 5:
+                if (pair)
+                    argv.push("-n").push("7"), count += 2;
+                else
+                    argv.push("-e"), count++;
+                break;
+            case 6: argv.push("--" + flag), count++; break;
+            case 7: argv.push("-s=hello"), count++; break;
+        }
+    }
+    return argv;
+}
+
+void benchAdd() {
+    for (size_t n : {10, 100, 1000, 10000}) {
+        const auto opts = names("opt", n);
+        bench::Argv argv;
+        bench::run(
+            "add/opt",
+            "option",
+            n,
+            [&] { return make_unique<clip::Parser>(argv.argc(), argv.argv(), clip::App("bench")); },
+            [&](auto &parser) {
+                for (const auto &name : opts)
+                    parser->add(clip::Opt<int>(name.data()).help("Sample integer."));
+            });
+        bench::run(
+            "add/borrow",
+            "option",
+            n,
+            [&] { return make_unique<clip::Parser>(argv.argc(), argv.argv(), clip::App("bench")); },
+            [&](auto &parser) {
+                for (const auto &name : opts)
+                    parser->add(
+                        clip::Opt<int>(name.data(), clip::borrowed).help("Sample integer."));
+            });
+    }
+}
+
+void benchParse() {
+    for (size_t n : {10, 100, 1000, 10000, 100000, 1000000}) {
+        bench::Argv argv = mixed(n);
+        bench::run(
+            "parse/mixed", "token", n, [&] { return schema(argv); }, [](auto &parser) {
+                parser->parse();
+            });
+    }
+}
+
+void benchReparse() {
+    for (size_t n : {10, 1000, 100000}) {
+        bench::Argv argv = mixed(n);
+        auto parser = schema(argv);
+        parser->freeze();
+        volatile bool sink = false;
+        bench::run(
+            "parse/reuse", "token", n, [&] { return parser.get(); }, [&](auto parser) {
+                clip::ArgvSource source(argv.argc() - 1, argv.argv() + 1);
+                sink = bool(parser->tryParse(source));
+            });
+    }
+}
+
+void benchConstraints() {
+    // Check thousands of rules against every option matched
+    for (size_t n : {100, 1000, 10000}) {
+        const auto opts = names("opt", n);
+        const auto flags = names("flag", n);
+        bench::Argv argv;
+        for (size_t i = 0; i < n; i++)
+            argv.push("--" + opts[i] + "=" + to_string(i));
+        for (bool constrained : {false, true}) {
+            clip::Parser parser(argv.argc(), argv.argv(), clip::App("bench"));
+            for (size_t i = 0; i < n; i++) {
+                parser.add(clip::Opt<int>(opts[i].data()).required(constrained));
+                parser.add(clip::Flag(flags[i].data()));
+            }
+            if (constrained) {
+                for (size_t i = 0; i < n; i++) {
+                    parser.conflicts(opts[i].data(), flags[i].data());
+                    parser.needs(opts[i].data(), opts[(i + 1) % n].data());
+                }
+                for (size_t i = 0; i + 1 < n; i += 2)
+                    parser.anyOf({opts[i].data(), opts[i + 1].data(), flags[i].data()});
+            }
+            parser.freeze();
+            clip::Result result(parser);
+            volatile bool sink = false;
+            bench::run(
+                constrained ? "parse/constrained" : "parse/unconstrained",
+                "token",
+                n,
+                [&] { return &parser; },
+                [&](auto parser) {
+                    result.reset();
+                    clip::ArgvSource source(argv.argc() - 1, argv.argv() + 1);
+                    sink = bool(parser->tryParse(source, result));
+                });
+        }
+    }
+}
+
+void benchAbbrev() {
+    // Resolve unique abbreviations of longnames
+    for (size_t n : {10, 1000, 100000}) {
+        bench::Argv argv;
+        for (size_t i = 0; i < NARGS; i++)
+            argv.push(to_string(i));
+        for (size_t i = NARGS; i < n; i++)
+            argv.push(i % 2 ? "--nu=7" : "--st=hello");
+        bench::run(
+            "parse/abbrev",
+            "token",
+            n,
+            [&] {
+                auto parser = schema(argv);
+                parser->abbreviate(true);
+                return parser;
+            },
+            [](auto &parser) { parser->parse(); });
+    }
+}
+
+void benchThreads() {
+    // Share one frozen parser across threads, each parsing into its own result
+    constexpr size_t n = 10000; // parses per thread
+    bench::Argv argv = mixed(64);
+    vector<string> tokens;
+    for (int i = 1; i < argv.argc(); i++)
+        tokens.emplace_back(argv.argv()[i]);
+    auto parser = schema(argv);
+    parser->freeze();
+    for (size_t nthreads : {1, 2, 4, 8, 16, 32, 64}) {
+        bench::run(
+            "parse/threads",
+            "parse",
+            n * nthreads,
+            [&] {
+                auto results = make_shared<vector<clip::Result>>();
+                for (size_t t = 0; t < nthreads; t++)
+                    results->emplace_back(*parser);
+                return results;
+            },
+            [&](auto &results) {
+                vector<thread> threads;
+                for (auto &result : *results)
+                    threads.emplace_back([&] {
+                        for (size_t i = 0; i < n; i++) {
+                            clip::RangeSource source(tokens.begin(), tokens.end());
+                            if (!parser->tryParse(source, result))
+                                abort();
+                        }
+                    });
+                for (auto &thread : threads)
+                    thread.join();
+            });
+    }
+}
+
+void benchParallel() {
+    // Convert a million positional values, spread across threads once classified
+    constexpr size_t n = 1000000;
+    bench::Argv argv;
+    for (size_t i = 0; i < n; i++)
+        argv.push(to_string(i * 2654435761 % 1000000007));
+    for (size_t nthreads : {1, 2, 4, 8, 16}) {
+        clip::Parser parser(argv.argc(), argv.argv(), clip::App("bench"));
+        parser.add(clip::Arg<vector<long>>("values"));
+        parser.parallel(nthreads);
+        parser.freeze();
+        clip::Result result(parser);
+        const string name = "parse/parallel/" + to_string(nthreads);
+        bench::run(
+            name.data(),
+            "value",
+            n,
+            [&] { return &parser; },
+            [&](auto parser) {
+                result.reset();
+                clip::ArgvSource source(argv.argc() - 1, argv.argv() + 1);
+                if (!parser->tryParse(source, result))
+                    abort();
+            });
+    }
+}
+
+void benchEnv() {
+    // Resolve variables for half of `n` options in a single pass over the environment
+    for (size_t n : {10, 1000, 10000}) {
+        const auto opts = names("opt", n);
+        bench::Argv argv;
+        argv.push("--opt0=42");
+        clip::Parser parser(argv.argc(), argv.argv(), clip::App("bench").env("BENCH_"));
+        for (const auto &name : opts)
+            parser.add(clip::Opt<int>(name.data()).longname(name.data()).help("Sample integer."));
+        for (size_t i = 0; i < n; i += 2)
+            ::setenv(("BENCH_OPT" + to_string(i)).data(), "7", 1);
+        parser.freeze();
+        volatile bool sink = false;
+        bench::run(
+            "parse/env", "option", n, [&] { return &parser; }, [&](auto parser) {
+                sink = bool(parser->tryParse());
+            });
+        for (size_t i = 0; i < n; i += 2)
+            ::unsetenv(("BENCH_OPT" + to_string(i)).data());
+    }
+}
+
+void benchConfig() {
+    // Layer a config file of `n` lines (about 1 MB at most) beneath the command line
+    constexpr size_t NKEYS = 512;
+    const auto opts = names("opt", NKEYS);
+    for (size_t n : {100, 10000, 100000}) {
+        char path[] = "/tmp/clip-bench-XXXXXX";
+        int fd = ::mkstemp(path);
+        string text = "# Sample config\n[bench]\n";
+        for (size_t i = 0; i < n; i++)
+            text += opts[i % NKEYS] + " = " + to_string(i) + "\n";
+        if (fd < 0 || ::write(fd, text.data(), text.size()) != ssize_t(text.size()))
+            abort();
+        ::close(fd);
+
+        bench::Argv argv;
+        argv.push("--bench-opt0=42");
+        clip::Parser parser(argv.argc(), argv.argv(), clip::App("bench"));
+        for (const auto &name : opts) {
+            string longname = "bench-" + name;
+            parser.add(clip::Opt<int>(name.data()).longname(longname.data()).help("Sample."));
+        }
+        parser.config(path);
+        parser.freeze();
+        volatile bool sink = false;
+        bench::run(
+            "parse/config", "line", n, [&] { return &parser; }, [&](auto parser) {
+                sink = bool(parser->tryParse());
+            });
+        ::unlink(path);
+    }
+}
+
+void benchRepeated() {
+    for (size_t n : {10, 1000, 100000}) {
+        bench::Argv argv;
+        for (size_t i = 0; i < n; i++)
+            argv.push("-I"), argv.push("/usr/include");
+        bench::run(
+            "parse/repeated",
+            "occurrence",
+            n,
+            [&] {
+                auto parser =
+                    make_unique<clip::Parser>(argv.argc(), argv.argv(), clip::App("bench"));
+                parser->add(clip::Opt<vector<string>>("include").shortname('I'));
+                parser->freeze();
+                return parser;
+            },
+            [](auto &parser) { parser->parse(); });
+    }
+}
+
+void benchResponse() {
+    for (size_t n : {1000, 100000, 1000000}) {
+        // Write response file
+        char path[] = "/tmp/clip-bench-XXXXXX";
+        int fd = ::mkstemp(path);
+        if (fd < 0)
+            return;
+        FILE *file = ::fdopen(fd, "w");
+        for (size_t i = 0; i < n; i++)
+            fprintf(file, i % 2 ? "-I /usr/include\n" : "-I \"/usr/local/include\"\n");
+        fclose(file);
+        bench::Argv argv;
+        argv.push(string("@") + path);
+        bench::run(
+            "parse/response",
+            "occurrence",
+            n,
+            [&] {
+                auto parser =
+                    make_unique<clip::Parser>(argv.argc(), argv.argv(), clip::App("bench"));
+                parser->add(clip::Opt<vector<string>>("include").shortname('I'));
+                parser->freeze();
+                return parser;
+            },
+            [](auto &parser) { parser->parse(); });
+        ::unlink(path);
+    }
+}
+
+void benchStream() {
+    for (size_t n : {1000, 100000, 1000000}) {
+        // Write NUL-delimited tokens
+        char path[] = "/tmp/clip-bench-XXXXXX";
+        int fd = ::mkstemp(path);
+        if (fd < 0)
+            return;
+        FILE *file = ::fdopen(fd, "w");
+        for (size_t i = 0; i < n; i++) {
+            if (i % 2)
+                fputs("--flag0", file);
+            else
+                fprintf(file, "-n%zu", i);
+            fputc('\0', file);
+        }
+        fclose(file);
+        bench::Argv argv;
+        bench::run(
+            "parse/stream",
+            "token",
+            n,
+            [&] {
+                auto parser =
+                    make_unique<clip::Parser>(argv.argc(), argv.argv(), clip::App("bench"));
+                parser->add(clip::Flag("flag0"));
+                parser->add(clip::Opt<int>("num").shortname('n'));
+                parser->freeze();
+                return parser;
+            },
+            [&](auto &parser) {
+                int fd = ::open(path, O_RDONLY);
+                clip::FdSource source(fd);
+                parser->parse(source);
+                ::close(fd);
+            });
+        ::unlink(path);
+    }
+}
+
+void benchConvert() {
+    constexpr size_t n = 100000;
+    auto run = [&](const char *name, auto type, vector<string> inputs) {
+        volatile bool sink = false;
+        bench::run(
+            name, "value", n, [&] { return &inputs; }, [&](auto inputs) {
+                decltype(type) value;
+                for (size_t i = 0; i < n; i++)
+                    sink = clip::convert((*inputs)[i % inputs->size()], value);
+            });
+    };
+    run("convert/int", int(), {"42", "-7", "+1000", "2147483647"});
+    run("convert/uint64", uint64_t(), {"0x1f", "0b1010", "18446744073709551615", "64"});
+    run("convert/size", size_t(), {"64K", "2GiB", "1.5M", "100KB"});
+    run("convert/double", double(), {"3.14", "-2e10", "+0.5", "1e-300"});
+    run("convert/duration", chrono::milliseconds(), {"250ms", "1.5s", "2m", "0.5h"});
+}
+
+template <size_t N>
+void benchChoice() {
+    // Resolve each of `N` spellings through a choice table, against the string-compare chain it
+    // replaces
+    constexpr size_t n = N;
+    static const auto spellings = names("target-", N);
+    auto table = make_unique<clip::Choices<size_t, N>>([] {
+        array<clip::Choice<size_t>, N> choices;
+        for (size_t i = 0; i < N; i++)
+            choices[i] = {spellings[i], i};
+        return choices;
+    }());
+    volatile size_t sink = 0;
+    bench::run("convert/choice", "value", n, [] { return 0; }, [&](int) {
+        for (size_t i = 0; i < n; i++)
+            if (const size_t *value = table->find(spellings[i * 7919 % N]))
+                sink = *value;
+    });
+    bench::run("convert/chain", "value", n, [] { return 0; }, [&](int) {
+        for (size_t i = 0; i < n; i++) {
+            string_view token = spellings[i * 7919 % N];
+            for (size_t j = 0; j < N; j++)
+                if (token == spellings[j]) {
+                    sink = j;
+                    break;
+                }
+        }
+    });
+}
+
+void benchStartup() {
+    bench::Argv argv;
+    for (const char *token : {"0", "1", "2", "3", "-abc", "--flag3", "-n7", "-s", "hello", "-f"})
+        argv.push(token);
+    const size_t n = argv.argc() - 1;
+    bench::run(
+        "startup/dynamic", "token", n, [&] { return &argv; }, [&](auto argv) {
+            clip::Parser parser(argv->argc(), argv->argv(), clip::App("bench"));
+            for (size_t i = 0; i < NFLAGS; i++) {
+                string name = "flag" + to_string(i);
+                parser.add(clip::Flag(name.data()).shortname('a' + i).help("Sample flag."));
+            }
+            parser.add(clip::Opt<int>("num").shortname('n').help("Sample short integer."));
+            parser.add(clip::Opt<string>("str").shortname('s').help("Sample short string."));
+            for (size_t i = 0; i < NARGS; i++) {
+                string name = "arg" + to_string(i);
+                parser.add(clip::Arg<int>(name.data()).help("Sample positional."));
+            }
+            parser.parse();
+        });
+    volatile unsigned int sink = 0;
+    static const clip::App app("bench");
+    bench::run(
+        "startup/static", "token", n, [&] { return &argv; }, [&](auto argv) {
+            auto matches = STATIC.parse(app, argv->argc(), argv->argv());
+            sink = sink + matches.count(STATIC.index("num"));
+        });
+}
+
+void benchCommands() {
+    // Only the selected tool's params should be built
+    for (size_t n : {10, 150, 1000}) {
+        const auto tools = names("tool", n);
+        bench::Argv argv;
+        argv.push(tools[n / 2]).push("--opt3=42").push("-a");
+        bench::run(
+            "startup/commands", "command", n, [&] { return &argv; }, [&](auto argv) {
+                clip::Parser parser(argv->argc(), argv->argv(), clip::App("bench"));
+                for (const auto &tool : tools)
+                    parser.command(tool.data(), "Sample tool.", [](clip::Parser &sub) {
+                        for (size_t i = 0; i < 8; i++) {
+                            string name = "opt" + to_string(i);
+                            sub.add(clip::Opt<int>(name.data()).help("Sample integer."));
+                        }
+                        sub.add(clip::Flag("flag0").shortname('a').help("Sample flag."));
+                    });
+                parser.parse();
+            });
+    }
+}
+
+void benchComplete() {
+    // Answer a completion query from scratch, as on each keypress
+    for (size_t n : {100, 3000}) {
+        const auto opts = names("opt", n);
+        bench::Argv argv;
+        argv.push("--clip-complete").push("2").push("bench").push("-a").push("--opt29");
+        volatile size_t sink = 0;
+        bench::run(
+            "startup/complete", "option", n, [&] { return &argv; }, [&](auto argv) {
+                clip::Parser parser(argv->argc(), argv->argv(), clip::App("bench"));
+                for (const auto &name : opts)
+                    parser.add(clip::Opt<int>(name.data()).help("Sample integer."));
+                parser.add(clip::Flag("flag0").shortname('a').help("Sample flag."));
+                sink = sink + parser.tryParse().error().message.size();
+            });
+    }
+}
+
+void benchGet() {
+    for (size_t n : {10, 100, 1000, 10000}) {
+        const auto opts = names("opt", n);
+        const auto args = names("arg", n);
+        bench::Argv argv;
+        clip::Parser parser(argv.argc(), argv.argv(), clip::App("bench"));
+        vector<clip::Handle<clip::Opt<int>>> handles;
+        for (const auto &name : opts)
+            handles.push_back(parser.add(clip::Opt<int>(name.data())));
+        for (const auto &name : args)
+            parser.add(clip::Arg<int>(name.data()));
+        parser.freeze();
+        volatile int sink = 0;
+        bench::run(
+            "get/opt", "lookup", n, [&] { return &parser; }, [&](auto parser) {
+                for (const auto &name : opts)
+                    sink = sink + parser->template getOpt<int>(name.data()).value();
+            });
+        bench::run(
+            "get/arg", "lookup", n, [&] { return &parser; }, [&](auto parser) {
+                for (const auto &name : args)
+                    sink = sink + parser->template getArg<int>(name.data()).value();
+            });
+        bench::run(
+            "get/handle", "lookup", n, [&] { return &handles; }, [&](auto handles) {
+                for (const auto &handle : *handles)
+                    sink = sink + handle->value();
+            });
+    }
+}
+
+void benchHelp() {
+    for (size_t n : {10, 100, 3000, 10000}) {
+        const auto opts = names("opt", n);
+        bench::Argv argv;
+        clip::Parser parser(argv.argc(), argv.argv(), clip::App("bench").version("0.0.0"));
+        for (const auto &name : opts)
+            parser.add(clip::Opt<int>(name.data()).help("Sample integer."));
+        parser.freeze();
+        volatile size_t sink = 0;
+        bench::run(
+            "help/opt", "option", n, [&] { return &parser; }, [&](auto parser) {
+                sink = sink + clip::detail::Formatters::help(*parser).size();
+            });
+        int fd = ::open("/dev/null", O_WRONLY);
+        bench::run(
+            "help/print", "option", n, [&] { return &parser; }, [&](auto parser) {
+                parser->printHelp(fd);
+            });
+        ::close(fd);
+    }
+}
+
+} // namespace
+
+int main() {
+    benchAdd();
+    benchParse();
+    benchReparse();
+    benchConstraints();
+    benchAbbrev();
+    benchThreads();
+    benchParallel();
+    benchEnv();
+    benchConfig();
+    benchRepeated();
+    benchResponse();
+    benchStream();
+    benchConvert();
+    benchChoice<8>();
+    benchChoice<64>();
+    benchChoice<2000>();
+    benchStartup();
+    benchCommands();
+    benchComplete();
+    benchGet();
+    benchHelp();
+}
@@ -24,6 +24,8 @@ private:
     std::string about_;
     std::string author_;
     std::string version_;
+    std::string env_;
+    std::string envargs_;
 
 public:
     // ctors
@@ -33,11 +35,17 @@ public:
     App &about(const char *s);
     App &author(const char *s);
     App &version(const char *s);
+    // Prefix deriving an environment variable for each option without one (e.g. `APP_`)
+    App &env(const char *prefix);
+    // Environment variable holding arguments to parse before the command line
+    App &envargs(const char *var);
 
     // accessors
     const std::string &about() const;
     const std::string &author() const;
     const std::string &version() const;
+    const std::string &env() const;
+    const std::string &envargs() const;
 };
 
 } // namespace clip
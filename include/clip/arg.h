@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <concepts>
+
 #include "clip/value.h"
 
 namespace clip {
@@ -18,6 +20,8 @@ class AbstractArg : public virtual AbstractValue {
 public:
     // ctors
     AbstractArg(const char *name);
+    AbstractArg(const AbstractArg &) = default;
+    AbstractArg(AbstractArg &&) = default;
 
     // dtor
     ~AbstractArg() = 0;
@@ -31,9 +35,14 @@ public:
     using AbstractValue::help;
     using AbstractValue::metavar;
     using AbstractValue::optional;
+    using AbstractValue::repeated;
 
     // methods (using)
+    using AbstractValue::finish;
+    using AbstractValue::intern;
     using AbstractValue::parse;
+    using AbstractValue::reserve;
+    using AbstractValue::reset;
 };
 
 template <typename T>
@@ -41,21 +50,86 @@ class Arg final : public AbstractArg, public Value<T> {
 public:
     // ctors
     Arg(const char *name);
+    Arg(const char *name, Borrowed);
 
     // builders (override)
     virtual Arg<T> &help(const char *s) override;
     virtual Arg<T> &metavar(const char *s) override;
     virtual Arg<T> &optional(bool b) override;
     virtual Arg<T> &value(const T &v) override;
+    virtual Arg<T> &bind(T *target) override;
+    Arg<T> &range(const detail::Scalar<T> &lo, const detail::Scalar<T> &hi)
+        requires std::totally_ordered<detail::Scalar<T>>;
 
     // accessors (using)
     using AbstractArg::help;
     using AbstractArg::metavar;
     using AbstractArg::optional;
+    using Value<T>::bind;
+    using Value<T>::repeated;
     using Value<T>::value;
 
     // methods (using)
+    using AbstractArg::intern;
+    using Value<T>::finish;
     using Value<T>::parse;
+    using Value<T>::reserve;
+    using Value<T>::reset;
 };
 
+// class Arg<T>
+// ctors
+template <typename T>
+Arg<T>::Arg(const char *name) :
+    Param(name),
+    AbstractValue(name, detail::choices<T>()),
+    AbstractArg(name),
+    Value<T>(name) {}
+
+template <typename T>
+Arg<T>::Arg(const char *name, Borrowed tag) :
+    Param(name, tag),
+    AbstractValue(name, detail::choices<T>()),
+    AbstractArg(name),
+    Value<T>(name) {}
+
+// builders (override)
+template <typename T>
+Arg<T> &Arg<T>::help(const char *s) {
+    this->AbstractArg::help(s);
+    return *this;
+}
+
+template <typename T>
+Arg<T> &Arg<T>::metavar(const char *s) {
+    this->AbstractArg::metavar(s);
+    return *this;
+}
+
+template <typename T>
+Arg<T> &Arg<T>::optional(bool b) {
+    this->AbstractArg::optional(b);
+    return *this;
+}
+
+template <typename T>
+Arg<T> &Arg<T>::value(const T &v) {
+    this->Value<T>::value(v);
+    return *this;
+}
+
+template <typename T>
+Arg<T> &Arg<T>::bind(T *target) {
+    this->Value<T>::bind(target);
+    return *this;
+}
+
+template <typename T>
+Arg<T> &Arg<T>::range(const detail::Scalar<T> &lo, const detail::Scalar<T> &hi)
+    requires std::totally_ordered<detail::Scalar<T>>
+{
+    this->Value<T>::range(lo, hi);
+    return *this;
+}
+
 } // namespace clip
@@ -0,0 +1,151 @@
+//
+//  choice.h
+//  Command line interface choice values.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "clip/hash.h"
+
+namespace clip {
+
+// struct Choice<T>
+// Spelling of a value.
+template <typename T>
+struct Choice {
+    std::string_view name;
+    T value;
+};
+
+// class Choices<T, N>
+// Table of the spellings allowed for a value.
+//
+// Declaring a `constexpr` table builds a perfect hash over its names during compilation, so
+// lookup is a single probe and performs no allocation. Names keep their declared order for help
+// and completion.
+template <typename T, std::size_t N>
+class Choices final {
+public:
+    // types
+    using value_type = T;
+
+private:
+    // impl members
+    std::array<T, N> values;
+    std::array<std::string_view, N> names_;
+    std::array<std::uint32_t, hash::buckets(N)> disps;
+    std::array<std::uint32_t, hash::slots(N)> table;
+
+public:
+    // ctors
+    constexpr Choices(const std::array<Choice<T>, N> &choices) :
+        values(),
+        names_(),
+        disps(),
+        table() {
+        for (std::size_t i = 0; i < N; i++) {
+            if (choices[i].name.empty())
+                throw std::invalid_argument("empty choice");
+            this->names_[i] = choices[i].name;
+            this->values[i] = choices[i].value;
+        }
+        // Ensure no duplicates
+        std::array<std::uint64_t, N> hashes{};
+        std::array<std::uint32_t, N> order{};
+        if (hash::duplicate(this->names_, hashes, order) != N)
+            throw std::invalid_argument("duplicate choice");
+
+        // Build perfect hash
+        std::array<std::uint32_t, hash::scratch(N)> tmp{};
+        if (!hash::build(this->names_, this->disps, this->table, tmp))
+            throw std::invalid_argument("unable to hash choices");
+    }
+
+    // accessors
+    constexpr std::size_t size() const {
+        return N;
+    }
+
+    constexpr std::span<const std::string_view> names() const {
+        return this->names_;
+    }
+
+    // Value spelled `name` (or null)
+    constexpr const T *find(std::string_view name) const {
+        std::uint64_t h = hash::fnv1a(name);
+        std::uint32_t i = this->table[hash::slot(h, this->disps, this->table.size())];
+        return (i != hash::EMPTY && this->names_[i] == name) ? &this->values[i] : nullptr;
+    }
+};
+
+namespace detail {
+
+// Check choices for duplicate names
+template <typename Choices>
+constexpr bool distinct(const Choices &choices) {
+    std::array<std::string_view, std::tuple_size_v<Choices>> names{};
+    std::array<std::uint64_t, std::tuple_size_v<Choices>> hashes{};
+    std::array<std::uint32_t, std::tuple_size_v<Choices>> order{};
+    for (std::size_t i = 0; i < names.size(); i++)
+        names[i] = choices[i].name;
+    return hash::duplicate(names, hashes, order) == names.size();
+}
+
+} // namespace detail
+
+// Build a choice table from a function returning its choices
+//
+// Duplicate names are reported through `static_assert`:
+//
+//     enum class Level { Low, High };
+//
+//     inline constexpr auto LEVELS = clip::choices([] {
+//         return std::array{
+//             clip::Choice{"low", Level::Low},
+//             clip::Choice{"high", Level::High},
+//         };
+//     });
+template <typename F>
+consteval auto choices(F) {
+    constexpr auto entries = F()();
+    using T = decltype(entries[0].value);
+    static_assert(detail::distinct(entries), "clip: duplicate choice");
+    return Choices<T, entries.size()>(entries);
+}
+
+// struct ChoiceTraits<CHOICES>
+// `ValueTraits` of a type spelled by a choice table, which also lists its names for help and
+// completion:
+//
+//     template <>
+//     struct clip::ValueTraits<Level> : clip::ChoiceTraits<LEVELS> {};
+template <const auto &CHOICES>
+struct ChoiceTraits {
+    using T = typename std::remove_cvref_t<decltype(CHOICES)>::value_type;
+
+    static bool parse(std::string_view s, T &value) {
+        const T *match = CHOICES.find(s);
+        if (match)
+            value = *match;
+        return match;
+    }
+
+    static constexpr std::span<const std::string_view> choices() {
+        return CHOICES.names();
+    }
+};
+
+} // namespace clip
@@ -12,6 +12,14 @@
 
 #include "clip/app.h"
 #include "clip/arg.h"
+#include "clip/choice.h"
+#include "clip/config.h"
+#include "clip/convert.h"
+#include "clip/error.h"
 #include "clip/flag.h"
 #include "clip/opt.h"
 #include "clip/parser.h"
+#include "clip/result.h"
+#include "clip/schema.h"
+#include "clip/stats.h"
+#include "clip/token.h"
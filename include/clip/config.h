@@ -0,0 +1,79 @@
+//
+//  config.h
+//  Command line interface config files.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "clip/error.h"
+
+namespace clip {
+
+// class ConfigFile
+// Entries of an INI or TOML (subset) config file, read lazily from a private memory mapping.
+//
+// Each line holds a `key = value` entry, a `[section]` header or a comment (`#` or `;`). Keys
+// within a section are prefixed by its name and a `-` (so `file` in `[log]` is `log-file`).
+// Values are bare (ending at an inline comment), single quoted (literal) or double quoted
+// (allowing backslash escapes); an array `[a, b, ...]` on a single line produces an entry per
+// element. Escapes are removed in place, so values are views into the mapping which remain valid
+// for the lifetime of the file. Syntax errors end the entries, leaving an error behind.
+class ConfigFile final {
+public:
+    // types
+    struct Entry {
+        std::string_view key;
+        std::string_view value;
+        std::size_t line;
+    };
+
+private:
+    // impl members
+    std::string path;
+    char *data;
+    std::size_t size;
+    char *pos;    // start of the next line
+    char *cursor; // next array element (or null)
+    char *eol;    // end of the current line
+    std::size_t line;
+    std::string_view key; // of the current line
+    std::string buffer;   // section prefix, followed by the current key
+    std::size_t prefix;   // length of the section prefix
+    std::optional<Error> error_;
+
+public:
+    // ctors
+    ConfigFile(const char *path);
+    ConfigFile(const ConfigFile &) = delete;
+    ConfigFile &operator=(const ConfigFile &) = delete;
+
+    // dtor
+    ~ConfigFile();
+
+    // accessors
+    const std::optional<Error> &error() const;
+
+    // methods
+    // Read the next entry, returning false once exhausted
+    bool next(Entry &entry);
+    // Report an error at the current line
+    Error fail(Errc code, std::string_view msg) const;
+
+private:
+    // helpers
+    bool element(Entry &entry);
+    bool scalar(char *&p, std::string_view &value, bool array);
+    bool rest(char *p);
+};
+
+} // namespace clip
@@ -0,0 +1,99 @@
+//
+//  constraint.h
+//  Command line interface param constraints.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace clip {
+
+// class Constraints
+// Frozen rules between param slots, checked together once parsing completes.
+//
+// Rules are compiled into masks over slots, so checking them against the bitset of matched slots
+// costs a word-wide operation per 64 slots instead of a lookup per name. Masks keep only their
+// nonzero words, so a rule's cost is independent of how many slots there are.
+class Constraints final {
+public:
+    // types
+    using Word = std::uint64_t;
+    // Kinds of rule
+    enum class Rule : unsigned char {
+        None,
+        Required,  // slot must be matched
+        Conflicts, // slot must not be matched alongside another
+        Needs,     // slot must not be matched without another
+        AnyOf,     // at least one slot of a group must be matched
+        OneOf,     // exactly one slot of a group must be matched
+    };
+    // Rule broken by a parse
+    struct Violation {
+        Rule rule;
+        std::size_t idx;   // slot (or group) breaking the rule
+        std::size_t other; // slot conflicted with or needed (or slots matched within a group)
+    };
+
+    // constants
+    static constexpr std::size_t BITS = 64;
+
+private:
+    // types
+    // Rows of masks, each holding only its nonzero words
+    struct Sparse {
+        std::vector<std::uint32_t> offsets;                  // of each row (and the end)
+        std::vector<std::pair<std::uint32_t, Word>> entries; // word index and bits
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pending; // row and bit (unbuilt)
+    };
+
+    // impl members
+    std::size_t nwords;
+    std::vector<Word> required;
+    std::vector<Word> ranged;
+    std::vector<Word> related; // slots with conflicts or needs
+    Sparse conflicts;
+    Sparse needs;
+    Sparse members;
+    std::vector<Rule> groups;
+
+public:
+    // ctors
+    Constraints();
+
+    // mutators
+    // Drop all rules, sizing masks for `n` slots
+    void clear(std::size_t n);
+    void require(std::size_t idx);
+    // Mark a slot as holding a value checked against its range
+    void range(std::size_t idx);
+    void conflict(std::size_t idx, std::size_t other);
+    void need(std::size_t idx, std::size_t other);
+    void group(Rule rule, std::span<const std::size_t> slots);
+    // Compile rules added since clearing
+    void build();
+
+    // accessors
+    // Words within a bitset of slots
+    std::size_t words() const;
+    bool empty() const;
+    // Slots with ranges
+    std::span<const Word> ranges() const;
+    // Slots within group `idx`
+    std::vector<std::size_t> group(std::size_t idx) const;
+
+    // methods
+    // First rule broken given the bitset of matched slots (`Rule::None` if all hold)
+    Violation check(const Word *matched) const;
+};
+
+} // namespace clip
@@ -0,0 +1,153 @@
+//
+//  convert.h
+//  Command line interface value conversion.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace clip {
+
+namespace detail {
+
+// Parse the magnitude and sign of an integer (failing beyond 64 bits)
+bool integer(std::string_view s, unsigned long long &magnitude, bool &negative);
+// Parse the magnitude and sign of a duration in ticks of `num / den` seconds
+bool duration(std::string_view s,
+              unsigned long long num,
+              unsigned long long den,
+              unsigned long long &magnitude,
+              bool &negative);
+// ... allowing a fraction of a tick
+bool duration(std::string_view s,
+              unsigned long long num,
+              unsigned long long den,
+              long double &ticks);
+
+// Narrow a signed magnitude into an integer type
+template <typename T>
+bool narrow(unsigned long long magnitude, bool negative, T &value) {
+    using U = std::make_unsigned_t<T>;
+    unsigned long long max = std::numeric_limits<T>::max();
+    if (negative)
+        max = std::is_signed_v<T> ? max + 1 : 0;
+    if (magnitude > max)
+        return false;
+    value = static_cast<T>(negative ? U(0) - static_cast<U>(magnitude) : static_cast<U>(magnitude));
+    return true;
+}
+
+} // namespace detail
+
+// struct ValueTraits<T>
+// Customization point for parsing values of type `T`.
+//
+// Specializations provide `static bool parse(std::string_view s, T &value)`, which converts a
+// token in place (leaving `value` untouched if it is invalid). Any default-constructible, copyable
+// type with a specialization may be held by an `Opt<T>` or `Arg<T>`, as may `std::vector<T>` and
+// `Set<T>` (the latter also requiring `operator<` and `operator==`):
+//
+//     template <>
+//     struct clip::ValueTraits<Level> {
+//         static bool parse(std::string_view s, Level &value);
+//     };
+//
+// Tokens are views into `argv` (or a mapped file), so conversion never round-trips through a
+// `std::string`.
+template <typename T>
+struct ValueTraits;
+
+// Integers accept an optional sign, and either a `0x`, `0o` or `0b` prefix, or a decimal with an
+// optional fraction and size suffix (`K`, `M`, `G`, `T`, `P`, `E` and their `KiB` forms are powers
+// of 1024; `KB` forms are powers of 1000). The result must be an exact integer, so `1.5K` is 1536
+// while `1.5` is invalid, and a fraction must have digits, so `1.` is invalid too.
+template <typename T>
+    requires std::integral<T> && (!std::same_as<T, bool>)
+struct ValueTraits<T> {
+    static bool parse(std::string_view s, T &value) {
+        unsigned long long magnitude;
+        bool negative;
+        return detail::integer(s, magnitude, negative) &&
+               detail::narrow(magnitude, negative, value);
+    }
+};
+
+// Floating point values use `std::from_chars`, with an optional leading `+` (though not `+-`).
+template <std::floating_point T>
+struct ValueTraits<T> {
+    static bool parse(std::string_view s, T &value) {
+        // Allow explicit positive sign (though not followed by another)
+        if (s.starts_with('+') && !s.substr(1).starts_with('-'))
+            s.remove_prefix(1);
+        T value_;
+        auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value_);
+        // Check entire string was parsed
+        bool success = ec == std::errc() && end == s.data() + s.size();
+        if (success)
+            value = value_;
+        return success;
+    }
+};
+
+// Durations accept a decimal with an optional unit (`ns`, `us`, `ms`, `s`, `m`, `min`, `h`, `d`);
+// bare numbers are in the duration's own period. With an integral representation the result must
+// be a whole number of ticks, so `1.5h` is 5400 seconds while `250ms` is not a valid number of
+// seconds; with a floating point one, `250ms` is 0.25 seconds.
+template <typename Rep, typename Period>
+    requires std::integral<Rep> || std::floating_point<Rep>
+struct ValueTraits<std::chrono::duration<Rep, Period>> {
+    static bool parse(std::string_view s, std::chrono::duration<Rep, Period> &value) {
+        Rep rep;
+        if constexpr (std::floating_point<Rep>) {
+            long double ticks;
+            constexpr long double max = std::numeric_limits<Rep>::max();
+            if (!detail::duration(s, Period::num, Period::den, ticks) || ticks > max ||
+                ticks < -max)
+                return false;
+            rep = static_cast<Rep>(ticks);
+        } else {
+            unsigned long long magnitude;
+            bool negative;
+            if (!detail::duration(s, Period::num, Period::den, magnitude, negative) ||
+                !detail::narrow(magnitude, negative, rep))
+                return false;
+        }
+        value = std::chrono::duration<Rep, Period>(rep);
+        return true;
+    }
+};
+
+// Strings must be non-empty.
+template <>
+struct ValueTraits<std::string> {
+    static bool parse(std::string_view s, std::string &value) {
+        bool success = !s.empty(); // check string is not empty
+        if (success)
+            value.assign(s); // reuses existing capacity
+        return success;
+    }
+};
+
+// Convert a string into a value (through its `ValueTraits<T>`)
+//
+// Returns false (leaving `value` untouched) if the string is invalid or out of range. Built-in
+// conversions are locale-independent.
+template <typename T>
+bool convert(std::string_view s, T &value) {
+    return ValueTraits<T>::parse(s, value);
+}
+
+} // namespace clip
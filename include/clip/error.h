@@ -0,0 +1,110 @@
+//
+//  error.h
+//  Command line interface parse errors.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+
+namespace clip {
+
+// Parse error codes
+enum class Errc : unsigned char {
+    Help,       // help was requested
+    Version,    // version was requested
+    Usage,      // no arguments were supplied
+    Complete,   // shell completion was requested (the message holds the output)
+    Unknown,    // unknown option
+    Missing,    // missing value or argument
+    Invalid,    // invalid value
+    Conflict,   // conflicting options
+    Unexpected, // unexpected token
+    Response,   // response file cannot be expanded
+    Config,     // config file cannot be read or parsed
+    Internal,   // internal error
+};
+
+// class Error
+struct Error final {
+    // members
+    Errc code;
+    std::string message;
+
+    // accessors
+    // Exit status conventionally used for this error
+    unsigned char status() const {
+        switch (this->code) {
+            case Errc::Help:
+            case Errc::Version:
+            case Errc::Complete: return 0;
+            case Errc::Internal: return 2;
+            default: return 1;
+        }
+    }
+};
+
+// class Expected<T>
+// Value or parse error, after `std::expected`.
+template <typename T>
+class Expected final {
+private:
+    // impl members
+    std::variant<T, Error> data;
+
+public:
+    // ctors
+    Expected(T value) : data(std::in_place_index<0>, std::move(value)) {}
+    Expected(Error error) : data(std::in_place_index<1>, std::move(error)) {}
+
+    // accessors
+    bool has_value() const {
+        return this->data.index() == 0;
+    }
+    explicit operator bool() const {
+        return this->has_value();
+    }
+    T &value() {
+        return std::get<0>(this->data);
+    }
+    const T &value() const {
+        return std::get<0>(this->data);
+    }
+    const Error &error() const {
+        return std::get<1>(this->data);
+    }
+};
+
+// class Expected<void>
+template <>
+class Expected<void> final {
+private:
+    // impl members
+    std::optional<Error> data;
+
+public:
+    // ctors
+    Expected() : data() {}
+    Expected(Error error) : data(std::move(error)) {}
+
+    // accessors
+    bool has_value() const {
+        return !this->data;
+    }
+    explicit operator bool() const {
+        return this->has_value();
+    }
+    const Error &error() const {
+        return *this->data;
+    }
+};
+
+} // namespace clip
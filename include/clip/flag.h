@@ -15,23 +15,39 @@
 namespace clip {
 
 class Flag final : public Option {
+private:
+    // mut members
+    unsigned int *bind_;
+
 public:
     // ctors
     Flag(const char *name);
+    Flag(const char *name, Borrowed);
 
+    // builders
+    // Store the count in `target` whenever a parse is published
+    Flag &bind(unsigned int *target);
     // builders (override)
     virtual Flag &help(const char *s) override;
     virtual Flag &longname(const char *s) override;
     virtual Flag &shortname(char c) override;
+    virtual Flag &env(const char *s) override;
+    virtual Flag &required(bool b) override;
 
+    // accessors
+    unsigned int *bind() const;
     // accessors (using)
     using Option::count;
+    using Option::env;
     using Option::help;
     using Option::longname;
+    using Option::required;
     using Option::shortname;
 
     // methods (using)
+    using Option::intern;
     using Option::match;
+    using Option::reset;
 };
 
 } // namespace clip
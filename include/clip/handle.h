@@ -0,0 +1,53 @@
+//
+//  handle.h
+//  Command line interface param handle.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+namespace clip {
+
+// forward declarations
+class Parser;
+
+// class Handle<P>
+// Typed reference to a param added to a `Parser`.
+//
+// Points directly at the parser's copy of the param, so access involves no name lookup or type
+// check. A handle remains valid for the lifetime of its parser, and adds further params to it so
+// that calls to `Parser::add` can still be chained.
+template <typename P>
+class Handle final {
+private:
+    // impl members
+    Parser *parser;
+    const P *param;
+
+    // ctors
+    Handle(Parser *parser, const P *param) : parser(parser), param(param) {}
+
+public:
+    // builders
+    // Add a param to the same parser, returning a handle to it
+    template <typename Q>
+    auto add(Q &&param) const;
+
+    // accessors
+    const P &operator*() const {
+        return *this->param;
+    }
+
+    const P *operator->() const {
+        return this->param;
+    }
+
+    // friends
+    friend class Parser;
+};
+
+} // namespace clip
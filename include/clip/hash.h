@@ -0,0 +1,171 @@
+//
+//  hash.h
+//  Command line interface perfect hashing.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace clip::hash {
+
+// Sentinel for an empty table slot
+constexpr std::uint32_t EMPTY = UINT32_MAX;
+
+// Hash a key (FNV-1a)
+constexpr std::uint64_t fnv1a(std::string_view s) {
+    std::uint64_t h = 0xcbf29ce484222325;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3;
+    }
+    return h;
+}
+
+// Mix a key's hash with its bucket's displacement
+constexpr std::uint64_t mix(std::uint64_t h, std::uint32_t d) {
+    h ^= (d + 1) * 0x9e3779b97f4a7c15;
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9;
+    h ^= h >> 29;
+    return h;
+}
+
+// Table dimensions for `n` keys
+constexpr std::size_t buckets(std::size_t n) {
+    return n / 2 + 1;
+}
+
+constexpr std::size_t slots(std::size_t n) {
+    return std::bit_ceil(n + 1) * 2;
+}
+
+constexpr std::size_t scratch(std::size_t n) {
+    return n + 2 * buckets(n) + 1;
+}
+
+// Bucket of a hashed key
+constexpr std::size_t bucket(std::uint64_t h, std::size_t nbuckets) {
+    return (h >> 32) % nbuckets;
+}
+
+// Slot of a hashed key within the table
+constexpr std::size_t slot(std::uint64_t h,
+                           std::span<const std::uint32_t> disps,
+                           std::size_t size) {
+    return mix(h, disps[bucket(h, disps.size())]) & (size - 1);
+}
+
+// Check keys for duplicates
+//
+// Returns the index of the first key that repeats an earlier one, or `keys.size()` when all keys
+// are unique. Empty keys are ignored. `hashes` and `order` must hold `keys.size()` entries.
+template <typename Keys>
+constexpr std::size_t duplicate(const Keys &keys,
+                                std::span<std::uint64_t> hashes,
+                                std::span<std::uint32_t> order) {
+    const std::size_t n = keys.size();
+    // Sort keys by hash
+    for (std::size_t i = 0; i < n; i++) {
+        hashes[i] = fnv1a(keys[i]);
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.begin() + n, [&](std::uint32_t a, std::uint32_t b) {
+        return hashes[a] < hashes[b] || (hashes[a] == hashes[b] && a < b);
+    });
+    // Compare keys with equal hashes
+    std::size_t dup = n;
+    for (std::size_t i = 0; i < n; i++) {
+        if (keys[order[i]].empty())
+            continue;
+        for (std::size_t j = i + 1; j < n && hashes[order[j]] == hashes[order[i]]; j++)
+            if (keys[order[j]] == keys[order[i]])
+                dup = std::min<std::size_t>(dup, order[j]);
+    }
+    return dup;
+}
+
+// Build a perfect hash over unique keys (hash and displace)
+//
+// Keys are grouped into buckets by their hash; buckets are then placed largest first, searching
+// for a displacement that sends every key in the bucket to a free slot. On success each key `i`
+// occupies `table[slot(fnv1a(keys[i]), disps, table.size())] == i`. Empty keys are skipped.
+//
+// `disps` must hold `buckets(n)` entries, `table` must hold `slots(n)` entries, and `tmp` must hold
+// `scratch(n)` entries.
+template <typename Keys>
+constexpr bool build(const Keys &keys,
+                     std::span<std::uint32_t> disps,
+                     std::span<std::uint32_t> table,
+                     std::span<std::uint32_t> tmp) {
+    const std::size_t n = keys.size();
+    const std::size_t nb = disps.size();
+    const std::size_t size = table.size();
+    // Partition scratch space
+    auto byBucket = tmp.subspan(0, n);    // key indices grouped by bucket
+    auto start = tmp.subspan(n, nb + 1);  // start of each bucket within `byBucket`
+    auto order = tmp.subspan(n + nb + 1); // buckets ordered by size
+
+    // Count keys per bucket
+    std::fill(start.begin(), start.end(), 0);
+    for (std::size_t i = 0; i < n; i++)
+        if (!keys[i].empty())
+            start[bucket(fnv1a(keys[i]), nb) + 1]++;
+    for (std::size_t b = 0; b < nb; b++)
+        start[b + 1] += start[b];
+    // Group keys by bucket
+    for (std::size_t b = 0; b < nb; b++)
+        order[b] = start[b];
+    for (std::size_t i = 0; i < n; i++)
+        if (!keys[i].empty())
+            byBucket[order[bucket(fnv1a(keys[i]), nb)]++] = i;
+    // Order buckets largest first
+    for (std::size_t b = 0; b < nb; b++)
+        order[b] = b;
+    std::sort(order.begin(), order.begin() + nb, [&](std::uint32_t a, std::uint32_t b) {
+        return start[a + 1] - start[a] > start[b + 1] - start[b];
+    });
+
+    // Place each bucket
+    std::fill(table.begin(), table.end(), EMPTY);
+    std::fill(disps.begin(), disps.end(), 0);
+    for (std::size_t k = 0; k < nb; k++) {
+        const std::size_t b = order[k];
+        const std::size_t first = start[b], last = start[b + 1];
+        if (first == last)
+            break; // remaining buckets are empty
+        std::uint32_t d = 0;
+        for (;; d++) {
+            if (d == UINT16_MAX)
+                return false; // give up
+            // Try this displacement
+            std::size_t placed = first;
+            for (; placed < last; placed++) {
+                std::size_t s = mix(fnv1a(keys[byBucket[placed]]), d) & (size - 1);
+                if (table[s] != EMPTY)
+                    break;
+                table[s] = byBucket[placed];
+            }
+            if (placed == last)
+                break; // found a displacement
+            // Undo partial placement
+            for (std::size_t i = first; i < placed; i++)
+                table[mix(fnv1a(keys[byBucket[i]]), d) & (size - 1)] = EMPTY;
+        }
+        disps[b] = d;
+    }
+
+    return true;
+}
+
+} // namespace clip::hash
@@ -0,0 +1,51 @@
+//
+//  index.h
+//  Command line interface lookup index.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "clip/hash.h"
+
+namespace clip {
+
+// class Index
+// Frozen lookup table from keys to param slots.
+//
+// Keys are views, so their storage must outlive the index. Small indices are scanned linearly;
+// larger ones are perfect-hashed once built.
+class Index final {
+public:
+    // constants
+    static constexpr std::size_t npos = hash::EMPTY;
+    static constexpr std::size_t LINEAR = 8;
+
+private:
+    // impl members
+    std::vector<std::string_view> keys;
+    std::vector<std::uint32_t> values;
+    std::vector<std::uint32_t> disps;
+    std::vector<std::uint32_t> table;
+
+public:
+    // mutators
+    void clear();
+    void insert(std::string_view key, std::size_t value);
+    void build();
+
+    // accessors
+    std::size_t size() const;
+    std::size_t find(std::string_view key) const;
+};
+
+} // namespace clip
@@ -10,15 +10,25 @@
 
 #pragma once
 
+#include <concepts>
+#include <cstddef>
+#include <memory_resource>
+
 #include "clip/option.h"
 #include "clip/value.h"
 
 namespace clip {
 
 class AbstractOpt : public Option, public virtual AbstractValue {
+private:
+    // mut members
+    std::size_t nargs_;
+
 public:
     // ctors
     AbstractOpt(const char *name);
+    AbstractOpt(const AbstractOpt &) = default;
+    AbstractOpt(AbstractOpt &&) = default;
 
     // dtor
     ~AbstractOpt() = 0;
@@ -27,20 +37,35 @@ public:
     virtual AbstractOpt &help(const char *s) override;
     virtual AbstractOpt &longname(const char *s) override;
     virtual AbstractOpt &shortname(char c) override;
+    virtual AbstractOpt &env(const char *s) override;
+    virtual AbstractOpt &required(bool b) override;
     virtual AbstractOpt &metavar(const char *s) override;
     virtual AbstractOpt &optional(bool b) override;
+    // builders
+    virtual AbstractOpt &nargs(std::size_t n);
 
+    // accessors
+    virtual std::size_t nargs() const final;
     // accessors (using)
     using AbstractValue::metavar;
     using AbstractValue::optional;
+    using AbstractValue::repeated;
     using Option::count;
+    using Option::env;
     using Option::help;
     using Option::longname;
+    using Option::required;
     using Option::shortname;
 
     // methods (using)
+    using AbstractValue::finish;
     using AbstractValue::parse;
+    using AbstractValue::reserve;
+    using AbstractValue::reset;
     using Option::match;
+
+    // methods
+    void intern(std::pmr::memory_resource *mr);
 };
 
 template <typename T>
@@ -48,27 +73,137 @@ class Opt final : public AbstractOpt, public Value<T> {
 public:
     // ctors
     Opt(const char *name);
+    Opt(const char *name, Borrowed);
 
     // builders (override)
     virtual Opt<T> &help(const char *s) override;
     virtual Opt<T> &longname(const char *s) override;
     virtual Opt<T> &shortname(char c) override;
+    virtual Opt<T> &env(const char *s) override;
+    virtual Opt<T> &required(bool b) override;
     virtual Opt<T> &metavar(const char *s) override;
     virtual Opt<T> &optional(bool b) override;
     virtual Opt<T> &value(const T &v) override;
+    virtual Opt<T> &bind(T *target) override;
+    Opt<T> &range(const detail::Scalar<T> &lo, const detail::Scalar<T> &hi)
+        requires std::totally_ordered<detail::Scalar<T>>;
+    virtual Opt<T> &nargs(std::size_t n) override;
 
     // accessors (using)
     using AbstractOpt::count;
+    using AbstractOpt::env;
     using AbstractOpt::help;
     using AbstractOpt::longname;
     using AbstractOpt::metavar;
+    using AbstractOpt::nargs;
     using AbstractOpt::optional;
+    using AbstractOpt::required;
     using AbstractOpt::shortname;
+    using Value<T>::bind;
+    using Value<T>::repeated;
     using Value<T>::value;
 
     // methods (using)
+    using AbstractOpt::intern;
     using AbstractOpt::match;
+    using Value<T>::finish;
     using Value<T>::parse;
+    using Value<T>::reserve;
+
+    // methods
+    virtual void reset() final override;
 };
 
+// class Opt<T>
+// ctors
+template <typename T>
+Opt<T>::Opt(const char *name) :
+    Param(name),
+    AbstractValue(name, detail::choices<T>()),
+    AbstractOpt(name),
+    Value<T>(name) {}
+
+template <typename T>
+Opt<T>::Opt(const char *name, Borrowed tag) :
+    Param(name, tag),
+    AbstractValue(name, detail::choices<T>()),
+    AbstractOpt(name),
+    Value<T>(name) {}
+
+// builders (override)
+template <typename T>
+Opt<T> &Opt<T>::help(const char *s) {
+    this->AbstractOpt::help(s);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::longname(const char *s) {
+    this->AbstractOpt::longname(s);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::shortname(char c) {
+    this->AbstractOpt::shortname(c);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::env(const char *s) {
+    this->AbstractOpt::env(s);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::required(bool b) {
+    this->AbstractOpt::required(b);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::metavar(const char *s) {
+    this->AbstractOpt::metavar(s);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::optional(bool b) {
+    this->AbstractOpt::optional(b);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::value(const T &v) {
+    this->Value<T>::value(v);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::bind(T *target) {
+    this->Value<T>::bind(target);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::range(const detail::Scalar<T> &lo, const detail::Scalar<T> &hi)
+    requires std::totally_ordered<detail::Scalar<T>>
+{
+    this->Value<T>::range(lo, hi);
+    return *this;
+}
+
+template <typename T>
+Opt<T> &Opt<T>::nargs(std::size_t n) {
+    this->AbstractOpt::nargs(n);
+    return *this;
+}
+
+// methods
+template <typename T>
+void Opt<T>::reset() {
+    this->Option::reset();
+    this->Value<T>::reset();
+}
+
 } // namespace clip
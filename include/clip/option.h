@@ -10,9 +10,10 @@
 
 #pragma once
 
-#include <string>
+#include <memory_resource>
 
 #include "clip/param.h"
+#include "clip/text.h"
 
 namespace clip {
 
@@ -20,8 +21,10 @@ namespace clip {
 class Option : public virtual Param {
 private:
     // mut members
-    std::string longname_;
+    Text longname_;
+    Text env_;
     char shortname_;
+    bool required_;
 
 protected:
     // impl members
@@ -30,6 +33,8 @@ protected:
 public:
     // ctors
     Option(const char *name);
+    Option(const Option &) = default;
+    Option(Option &&) = default;
 
     // dtor
     ~Option() = 0;
@@ -37,18 +42,26 @@ public:
     // builders
     virtual Option &longname(const char *s);
     virtual Option &shortname(char c);
+    virtual Option &env(const char *s);
+    // Fail parsing unless matched (from any source)
+    virtual Option &required(bool b);
     // builders (override)
     virtual Option &help(const char *s) override;
 
     // accessors
     virtual const char *longname() const final;
     virtual char shortname() const final;
+    virtual const char *env() const final;
+    virtual bool required() const final;
     virtual unsigned int count() const final;
     // accessors (using)
     using Param::help;
 
     // methods
     virtual void match() final;
+    void match(unsigned int n);
+    void reset();
+    void intern(std::pmr::memory_resource *mr);
 };
 
 } // namespace clip
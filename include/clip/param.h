@@ -10,23 +10,51 @@
 
 #pragma once
 
+#include <memory_resource>
 #include <string>
 
+#include "clip/text.h"
+
 namespace clip {
 
+namespace detail {
+
+// Unique address per type (usable without RTTI)
+template <typename T>
+inline constexpr char TYPEID = 0;
+
+} // namespace detail
+
+// Param kinds
+enum class Kind : unsigned char {
+    Flag,
+    Opt,
+    Arg,
+};
+
+// Tag for params that borrow their strings instead of copying them
+struct Borrowed {
+    explicit Borrowed() = default;
+};
+// Construct a param borrowing its strings (which must then outlive its parser)
+inline constexpr Borrowed borrowed{};
+
 // class Param
 class Param {
-public:
-    // const members
-    const std::string name;
-
 private:
+    // impl members
+    Text name_;
+
     // mut members
-    std::string help_;
+    Text help_;
+    bool borrow_;
 
 public:
     // ctors
     Param(const char *name);
+    Param(const char *name, Borrowed);
+    Param(const Param &) = default;
+    Param(Param &&) = default;
 
     // dtor
     virtual ~Param() = 0;
@@ -35,7 +63,13 @@ public:
     virtual Param &help(const char *s);
 
     // accessors
+    virtual const char *name() const final;
     virtual const char *help() const final;
+    // Whether strings are borrowed rather than copied
+    virtual bool borrow() const final;
+
+    // methods
+    void intern(std::pmr::memory_resource *mr);
 };
 
 } // namespace clip
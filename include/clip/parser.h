@@ -10,52 +10,256 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
 #include <memory>
-#include <sstream>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "clip/app.h"
+#include "clip/arg.h"
+#include "clip/constraint.h"
+#include "clip/error.h"
 #include "clip/flag.h"
+#include "clip/handle.h"
+#include "clip/index.h"
+#include "clip/opt.h"
+#include "clip/option.h"
 #include "clip/param.h"
+#include "clip/result.h"
+#include "clip/stats.h"
+#include "clip/text.h"
+#include "clip/value.h"
 
 namespace clip {
 
 // forward declarations
-class Option;
-template <typename T>
-class Arg;
-template <typename T>
-class Opt;
+class Source;
+class Tokens;
+namespace detail {
+// Reaches a parser's private formatters (defined by the test and benchmark harnesses)
+struct Formatters;
+} // namespace detail
 
 class Parser final {
 public:
+    // types
+    // Destroys an arena-allocated param without freeing its storage
+    struct Destroy {
+        void operator()(Param *param) const;
+    };
+    // Adds a subcommand's params to its parser
+    using Factory = std::function<void(Parser &)>;
+
     // const members
     const int argc;
     const char *const *const argv;
     const App app;
 
 private:
+    // types
+    // Type-erased operations on a value held within a `Result`
+    struct Ops {
+        const void *type;
+        std::size_t size;
+        std::size_t align;
+        void (*init)(void *value, const void *object);   // construct from the param's default
+        void (*assign)(void *value, const void *object); // assign from the param's default
+        void (*destroy)(void *value);
+        bool (*parse)(void *value, std::string_view s);
+        void (*clear)(void *value); // before the first parse since reset (null unless repeated)
+        void (*reserve)(void *value, std::size_t n);
+        void (*finish)(void *value);
+        void (*publish)(void *object, void *value); // exchange with the param's value
+        bool (*check)(const void *object, const void *value); // against the param's range
+        // Elements converted in place (null unless deferrable)
+        std::size_t (*extend)(void *value, std::size_t n); // returning the first added
+        bool (*convert)(void *value, std::size_t i, std::string_view s);
+    };
+
+    // Type-erased operations on a `Value<T>` held by a param of type `P`
+    template <typename P, typename T>
+    struct Erased {
+        // Whether elements can be converted concurrently (`std::vector<bool>` packs them)
+        static constexpr bool DEFERRABLE =
+            detail::REPEATED<T> && !std::is_same_v<detail::Scalar<T>, bool>;
+
+        static void init(void *value, const void *object) {
+            new (value) T(static_cast<const P *>(object)->initial());
+        }
+        static void assign(void *value, const void *object) {
+            *static_cast<T *>(value) = static_cast<const P *>(object)->initial();
+        }
+        static void destroy(void *value) {
+            static_cast<T *>(value)->~T();
+        }
+        static bool parse(void *value, std::string_view s) {
+            CLIP_STATS_TIME(convert);
+            CLIP_STATS_COUNT(conversions, 1);
+            return Value<T>::parse(*static_cast<T *>(value), s);
+        }
+        static void clear(void *value) {
+            Value<T>::clear(*static_cast<T *>(value));
+        }
+        static void reserve(void *value, std::size_t n) {
+            Value<T>::reserve(*static_cast<T *>(value), n);
+        }
+        static void finish(void *value) {
+            Value<T>::finish(*static_cast<T *>(value));
+        }
+        static void publish(void *object, void *value) {
+            static_cast<P *>(object)->swap(*static_cast<T *>(value));
+        }
+        static std::size_t extend(void *value, std::size_t n) {
+            if constexpr (DEFERRABLE) {
+                T &values = *static_cast<T *>(value);
+                std::size_t size = values.size();
+                values.resize(size + n);
+                return size;
+            } else {
+                return 0;
+            }
+        }
+        static bool convert(void *value, std::size_t i, std::string_view s) {
+            if constexpr (DEFERRABLE)
+                return clip::convert(s, (*static_cast<T *>(value))[i]);
+            else
+                return false;
+        }
+        static bool check(const void *object, const void *value) {
+            return static_cast<const P *>(object)->within(*static_cast<const T *>(value));
+        }
+        static void store(const void *object) {
+            const P *param = static_cast<const P *>(object);
+            *param->bind() = param->value();
+        }
+    };
+
+    // Type-erased view of a param, used for dispatch without RTTI
+    struct Slot {
+        Kind kind;
+        const void *type;
+        void *object;
+        Option *option;
+        AbstractValue *value;
+        const Ops *ops;
+        void (*store)(const void *object); // into the param's bound target (if any)
+        std::size_t offset; // of value within a `Result`
+        std::size_t nargs;
+        bool ranged;
+    };
+
+    // Names in sorted order, for prefix queries
+    using Sorted = std::vector<std::pair<std::string_view, std::size_t>>;
+
+    // Rule between params named by the caller (resolved once frozen)
+    struct Relation {
+        Constraints::Rule rule;
+        std::vector<std::string> names;
+    };
+
+    // Subcommand whose parser is built on first use
+    struct Command {
+        std::string name;
+        std::string help;
+        Factory factory;
+        std::unique_ptr<Parser> parser;
+        std::once_flag built;
+    };
+
     // impl members
-    std::unordered_map<std::string, std::unique_ptr<Param>> params;
-    std::unordered_map<std::string, std::string> longnames;
-    std::unordered_map<char, std::string> shortnames;
-    std::vector<std::string> flags;
-    std::vector<std::string> opts;
-    std::vector<std::string> args;
+    std::pmr::monotonic_buffer_resource arena; // params and their text (outlives `params`)
+    std::vector<std::unique_ptr<Param, Destroy>> params;
+    std::vector<Slot> slots;
+    std::vector<std::size_t> flags;
+    std::vector<std::size_t> opts;
+    std::vector<std::size_t> args;
+    std::vector<std::size_t> bound; // stored into on publish
+    std::pmr::unordered_set<std::string_view> addednames;     // checked for duplicates on add
+    std::pmr::unordered_set<std::string_view> addedlongnames; // ...
+    Index names;
+    Index longnames;
+    Sorted sortedlongnames;
+    Index prefixes; // of longnames, to their first position once sorted (if abbreviating)
+    std::array<std::uint32_t, 256> shortnames;
+    Index envnames;
+    mutable std::deque<Command> commands; // built lazily, at stable addresses
+    Index commandnames;
+    Sorted sortedcommands;
+    std::vector<std::string> configs; // in increasing precedence
+    std::vector<Relation> relations;
+    Constraints constraints;
+    std::size_t bits;       // of matched slots within a `Result`
+    std::size_t footprint;  // of a `Result`
+    std::size_t generation; // of the layout, checked by each `Result`
+    std::size_t nthreads;   // converting deferred values
+    std::unique_ptr<Result> state; // published into params by `parse()`
     bool autohelp;
+    bool autoflags;
+    bool frozen;
+    bool repeated;
+    bool abbrev;
+    bool constrained;
+    bool variadic; // last arg takes every remaining positional
+    mutable Stats stats_;
 
 public:
     // ctors
     Parser(int argc, char *argv[], const App &app);
+    // Parser for tokens supplied through a `Source`
+    explicit Parser(const App &app);
 
     // builders
-    Parser &add(const Flag &flag);
+    // Add a param, returning a handle to the parser's copy of it (through which more can be added)
+    //
+    // Throws `std::invalid_argument` if its name or longname is taken by an earlier param; such
+    // duplicates were once ignored, leaving the earlier param in place.
+    Handle<Flag> add(const Flag &flag);
+    Handle<Flag> add(Flag &&flag);
     template <typename T>
-    Parser &add(const Opt<T> &opt);
+    Handle<Opt<T>> add(const Opt<T> &opt);
     template <typename T>
-    Parser &add(const Arg<T> &arg);
+    Handle<Opt<T>> add(Opt<T> &&opt);
+    template <typename T>
+    Handle<Arg<T>> add(const Arg<T> &arg);
+    template <typename T>
+    Handle<Arg<T>> add(Arg<T> &&arg);
+    // Add a subcommand, whose params are added by `factory` only once it is selected
+    Parser &command(const char *name, const char *help, Factory factory);
+    // Accept unique prefixes of longnames (e.g. `--verb` for `--verbose`), after GNU
+    Parser &abbreviate(bool b);
+    // Add a config file, whose keys are matched against longnames (missing files are skipped)
+    //
+    // Values are taken in increasing precedence from defaults, config files (later files first),
+    // the environment and the command line.
+    Parser &config(const char *path);
+    // Reject `name` when matched alongside `other`
+    Parser &conflicts(const char *name, const char *other);
+    // Reject `name` when matched without `other`
+    Parser &needs(const char *name, const char *other);
+    // Require at least one of `names` to be matched
+    Parser &anyOf(std::initializer_list<const char *> names);
+    // Require exactly one of `names` to be matched
+    Parser &oneOf(std::initializer_list<const char *> names);
+    // Classify every token before converting values of repeated params, spread across up to
+    // `threads` threads (or one per core, if zero)
+    //
+    // Values are converted as they would be one at a time, so results and errors are the same
+    // (though values left by a failed parse are not). Only sources whose tokens remain valid
+    // throughout, such as argv, are deferred.
+    Parser &parallel(std::size_t threads);
 
     // accessors
     const decltype(params) &data();
@@ -66,23 +270,90 @@ public:
     const Opt<T> &getOpt(const char *name) const;
     template <typename T>
     const Arg<T> &getArg(const char *name) const;
+    // Parser of the subcommand selected by the last parse (or null)
+    Parser *command() const;
+    // Statistics accumulated so far (zero unless built with `CLIP_STATS`)
+    Stats stats() const;
 
     // methods
+    void freeze();
+    // Parse, printing help or errors and exiting where needed
     void parse();
+    void parse(Source &source);
+    // Parse without exiting, reporting help, version and errors as an `Error`
+    //
+    // Hidden entry points answer shell completion without parsing: `--clip-complete <cword>
+    // <words...>` lists candidates for `words[cword]`, and `--clip-complete-script <shell>` prints
+    // a script (for `bash`, `zsh` or `fish`) which calls it. Passing `--clip-trace=<path>` first
+    // of all (taken on construction) writes a trace to `path`, as described by `Stats`.
+    //
+    // Tokens of the app's `envargs` variable are parsed ahead of the source, and options left
+    // unmatched afterwards fall back to their environment variables, then to config files.
+    Expected<void> tryParse();
+    Expected<void> tryParse(Source &source);
+    // Parse into a separate result, leaving params untouched (thread-safe once frozen)
+    //
+    // Neither the environment nor config files are consulted.
+    Expected<void> tryParse(Source &source, Result &result) const;
+    // Restore every param touched by the last parse to its default
+    void reset();
+
+    // formatters
+    // Write help to `fd` in a single write, wrapped to its terminal width
+    void printHelp(int fd) const;
 
     // methods (static)
     static void error(unsigned char ret = 1, const std::string &msg = "unknown");
 
 private:
+    // accessors
+    // Param named `name`, checked to be of `type` (unless null)
+    const void *find(const char *name, const void *type) const;
+    template <typename P>
+    Handle<P> handle(std::size_t idx);
+
     // mutators
-    bool insert(Param *param);
+    template <typename P>
+    std::size_t insert(P &&param);
 
     // helpers
     void addAutoflags();
-    void checkAutoflags(Option *match) const;
-    bool parseLongOption(int &i);
-    bool parseShortOption(int &i);
-    bool parseArg(int &i, std::size_t &argidx);
+    void checkUnique(const char *name, const char *longname) const;
+    void layout();
+    Parser &build(std::size_t idx) const;
+    void publish(Result &result);
+    [[noreturn]] void exit(const Error &error) const;
+    Expected<void> parseTokens(Source &source, Result &result, bool layers) const;
+    Expected<void> parseTokens(Tokens &tokens, Result &result, bool layers) const;
+    Expected<void> parseLayers(Result &result) const;
+    Expected<void> parseEnv(Result &result) const;
+    Expected<void> parseConfig(Result &result, const char *path) const;
+    Expected<void> checkAutoflags(Option *match) const;
+    Expected<void> checkConstraints(Result &result) const;
+    // Bitset of slots matched so far (laid out when constrained or layered with config files)
+    Constraints::Word *mark(Result &result) const;
+    Expected<std::size_t> resolve(std::string_view longkey) const;
+    void match(Result &result, std::size_t idx) const;
+    bool parseValue(Result &result,
+                    std::size_t idx,
+                    std::string_view value,
+                    std::string_view key,
+                    unsigned char dash) const;
+    Expected<void> parseDeferred(Result &result) const;
+    Expected<void> parseLongOption(Tokens &tokens, Result &result, std::string_view arg) const;
+    Expected<void> parseShortOption(Tokens &tokens, Result &result, std::string_view arg) const;
+    Expected<void> parseNargs(Tokens &tokens,
+                              Result &result,
+                              std::size_t idx,
+                              const char *dash,
+                              std::string_view key) const;
+    void reserveRepeated(Result &result) const;
+    Expected<void> parseArg(Result &result, std::string_view value, std::size_t &argidx) const;
+    Expected<void> parseComplete();
+    Expected<void> parseCommand(Tokens &tokens,
+                                Result &result,
+                                std::size_t idx,
+                                bool layers) const;
 
     // formatters
     std::string help_s() const;
@@ -90,7 +361,183 @@ private:
     std::string flags_s() const;
     std::string opts_s() const;
     std::string args_s() const;
+    std::string commands_s() const;
     std::string version_s() const;
+    // Candidates completing `words[cword]`, one per line (values are left to the shell, unless
+    // restricted to choices)
+    std::string complete_s(std::size_t cword, const char *const *words, std::size_t nwords) const;
+    // Completion script for `shell` (one of `bash`, `zsh` or `fish`)
+    std::string script_s(std::string_view shell) const;
+
+    // formatters (helpers)
+    std::size_t measure(std::size_t width, std::size_t &size) const;
+    void formatHelp(std::string &out, std::size_t width) const;
+    void formatUsage(std::string &out) const;
+    std::string formatEntries(const std::vector<std::size_t> &entries) const;
+    void formatEntry(std::string &out,
+                     std::size_t idx,
+                     std::size_t column,
+                     std::size_t width) const;
+    void formatCommands(std::string &out, std::size_t column, std::size_t width) const;
+    static void formatPrefixed(std::string &out,
+                               const Sorted &sorted,
+                               std::string_view dash,
+                               std::string_view prefix);
+    static void formatChoices(std::string &out,
+                              std::span<const std::string_view> choices,
+                              std::string_view lead,
+                              std::string_view prefix);
+
+    // friends
+    friend class Result;
+    friend struct detail::Formatters;
 };
 
+// class Parser
+// builders
+template <typename T>
+Handle<Opt<T>> Parser::add(const Opt<T> &opt) {
+    // Insert param within parser, appending slot to opts
+    std::size_t idx = this->insert(opt);
+    this->opts.push_back(idx);
+    return this->handle<Opt<T>>(idx);
+}
+
+template <typename T>
+Handle<Opt<T>> Parser::add(Opt<T> &&opt) {
+    // Insert param within parser, appending slot to opts
+    std::size_t idx = this->insert(std::move(opt));
+    this->opts.push_back(idx);
+    return this->handle<Opt<T>>(idx);
+}
+
+template <typename T>
+Handle<Arg<T>> Parser::add(const Arg<T> &arg) {
+    // Update autohelp
+    if (this->autohelp && !arg.optional())
+        this->autohelp = false;
+    // Insert param within parser, appending slot to args
+    std::size_t idx = this->insert(arg);
+    this->args.push_back(idx);
+    return this->handle<Arg<T>>(idx);
+}
+
+template <typename T>
+Handle<Arg<T>> Parser::add(Arg<T> &&arg) {
+    // Update autohelp
+    if (this->autohelp && !arg.optional())
+        this->autohelp = false;
+    // Insert param within parser, appending slot to args
+    std::size_t idx = this->insert(std::move(arg));
+    this->args.push_back(idx);
+    return this->handle<Arg<T>>(idx);
+}
+
+// accessors
+template <typename P>
+const P &Parser::get(const char *name) const {
+    const void *type = std::is_same_v<P, Param> ? nullptr : &detail::TYPEID<P>;
+    return *static_cast<const P *>(this->find(name, type));
+}
+
+template <typename T>
+const Opt<T> &Parser::getOpt(const char *name) const {
+    return this->get<Opt<T>>(name);
+}
+
+template <typename T>
+const Arg<T> &Parser::getArg(const char *name) const {
+    return this->get<Arg<T>>(name);
+}
+
+template <typename P>
+Handle<P> Parser::handle(std::size_t idx) {
+    return Handle<P>(this, static_cast<const P *>(this->slots[idx].object));
+}
+
+// mutators
+template <typename Q>
+std::size_t Parser::insert(Q &&source) {
+    using P = std::remove_cvref_t<Q>;
+    CLIP_STATS_SCOPE(this->stats_);
+    CLIP_STATS_SPAN(add);
+    CLIP_STATS_COUNT(params, 1);
+    CLIP_STATS_COUNT(bytes, sizeof(P));
+    // Check param can be told apart from earlier ones
+    if constexpr (std::is_base_of_v<Option, P>)
+        this->checkUnique(source.name(), source.longname());
+    else
+        this->checkUnique(source.name(), "");
+
+    // Copy or move param into the arena, along with its text (copied straight there)
+    std::pmr::polymorphic_allocator<> alloc(&this->arena);
+    Text::Scope scope(&this->arena);
+    P *param = alloc.new_object<P>(std::forward<Q>(source));
+    param->intern(&this->arena);
+    this->addednames.insert(param->name());
+    if constexpr (std::is_base_of_v<Option, P>)
+        if (*param->longname())
+            this->addedlongnames.insert(param->longname());
+
+    // Describe param for dispatch
+    Slot slot{};
+    slot.nargs = 1;
+    slot.type = &detail::TYPEID<P>;
+    slot.object = param;
+    if constexpr (std::is_base_of_v<Option, P>)
+        slot.option = param;
+    if constexpr (std::is_base_of_v<AbstractValue, P>) {
+        using T = std::remove_cvref_t<decltype(param->value())>;
+        using E = Erased<P, T>;
+        static constexpr Ops OPS = {
+            &detail::TYPEID<T>,
+            sizeof(T),
+            alignof(T),
+            &E::init,
+            &E::assign,
+            &E::destroy,
+            &E::parse,
+            detail::REPEATED<T> ? &E::clear : nullptr,
+            &E::reserve,
+            &E::finish,
+            &E::publish,
+            &E::check,
+            E::DEFERRABLE ? &E::extend : nullptr,
+            E::DEFERRABLE ? &E::convert : nullptr,
+        };
+        slot.value = param;
+        slot.ops = &OPS;
+        slot.ranged = param->ranged();
+        if (param->bind())
+            slot.store = &E::store;
+    }
+    if constexpr (std::is_base_of_v<AbstractOpt, P>) {
+        slot.kind = Kind::Opt;
+        slot.nargs = param->nargs();
+    } else if constexpr (std::is_base_of_v<AbstractArg, P>) {
+        slot.kind = Kind::Arg;
+    } else {
+        slot.kind = Kind::Flag;
+        if (param->bind())
+            slot.store = [](const void *object) {
+                const P *flag = static_cast<const P *>(object);
+                *flag->bind() = flag->count();
+            };
+    }
+
+    // Append param
+    this->params.emplace_back(param);
+    this->slots.push_back(slot);
+    this->frozen = false;
+    return this->params.size() - 1;
+}
+
+// class Handle<P>
+// builders
+template <typename P>
+template <typename Q>
+auto Handle<P>::add(Q &&param) const {
+    return this->parser->add(std::forward<Q>(param));
+}
+
 } // namespace clip
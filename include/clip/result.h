@@ -0,0 +1,112 @@
+//
+//  result.h
+//  Command line interface parse result.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "clip/param.h"
+
+namespace clip {
+
+// forward declarations
+class App;
+class Parser;
+
+// class Result
+// Counts and values from a single parse of a frozen `Parser`.
+//
+// The parser acts as an immutable schema: any number of results may be parsed into concurrently,
+// each from its own thread. Counts and values are laid out by the parser into one cache-aligned
+// block, which is allocated once and reused across parses. A result must not outlive its parser.
+// Adding params lays the parser out afresh when next frozen, after which any earlier result is
+// rejected (throwing `std::logic_error`) rather than read through the new offsets.
+class Result final {
+public:
+    // constants
+    static constexpr std::size_t ALIGN = 64;
+
+private:
+    // types
+    // Value whose conversion is deferred until every token is classified
+    struct Deferred {
+        std::string_view value;
+        std::string_view key; // as spelled (empty for positionals)
+        std::uint32_t idx;
+        std::uint32_t pos;    // among values deferred to the same slot
+        unsigned char dash;   // spelled before the key
+    };
+
+    // Value as laid out on allocation (destroyed there, whatever the parser's current layout)
+    struct Placed {
+        void (*destroy)(void *value);
+        std::size_t offset;
+    };
+
+    // impl members
+    const Parser *parser;
+    std::size_t generation;             // of the parser's layout
+    std::byte *storage;                 // counts, followed by values
+    std::vector<Placed> placed;         // values within storage
+    std::vector<std::uint32_t> touched; // slots matched since the last reset
+    std::size_t command_;               // selected subcommand
+    std::unique_ptr<Result> sub;        // result of the selected subcommand
+    std::vector<Deferred> deferred;     // values awaiting conversion
+    std::vector<std::uint32_t> pending; // values deferred to each slot (then their first index)
+    bool deferring;                     // whether this parse defers conversions
+
+public:
+    // ctors
+    explicit Result(const Parser &parser);
+    Result(Result &&other) noexcept;
+    Result(const Result &) = delete;
+    Result &operator=(const Result &) = delete;
+
+    // dtor
+    ~Result();
+
+    // accessors
+    const App &app() const;
+    unsigned int count(const char *name) const;
+    template <typename T>
+    const T &value(const char *name) const;
+    // Result of the selected subcommand (or null)
+    const Result *command() const;
+
+    // methods
+    // Restore every slot touched by the last parse to its default
+    void reset();
+
+private:
+    // accessors
+    // Check the parser has not been laid out since
+    void check() const;
+    std::uint32_t *counts() const;
+    void *at(std::size_t idx) const;
+    // Value of the param named `name`, checked to be of `type`
+    const void *at(const char *name, const void *type) const;
+    std::size_t find(const char *name) const;
+
+    // friends
+    friend class Parser;
+};
+
+// class Result
+// accessors
+template <typename T>
+const T &Result::value(const char *name) const {
+    return *static_cast<const T *>(this->at(name, &detail::TYPEID<T>));
+}
+
+} // namespace clip
@@ -0,0 +1,406 @@
+//
+//  schema.h
+//  Command line interface compile-time schema.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "clip/app.h"
+#include "clip/convert.h"
+#include "clip/error.h"
+#include "clip/hash.h"
+#include "clip/param.h"
+#include "clip/token.h"
+
+namespace clip {
+
+namespace detail {
+
+// Check a token converts into a `T` (strings only need to be non-empty, so are not copied)
+template <typename T>
+bool accepts(std::string_view s) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return !s.empty();
+    } else {
+        T value{};
+        return ValueTraits<T>::parse(s, value);
+    }
+}
+
+// Check a longname is valid (alphanumeric, then alphanumeric or hyphens), as `Option` does
+constexpr bool isLongname(std::string_view s) {
+    auto alnum = [](char c) {
+        return ('0' <= c && c <= '9') || ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z');
+    };
+    if (s.empty() || !alnum(s.front()))
+        return false;
+    for (char c : s)
+        if (!alnum(c) && c != '-')
+            return false;
+    return true;
+}
+
+} // namespace detail
+
+// class Spec
+// Compile-time description of a param.
+//
+// Names are validated as a `Parser` would, so an invalid longname or shortname fails to compile.
+// Values of options and arguments are checked against their type `T` while parsing.
+class Spec final {
+public:
+    // types
+    using Kind = clip::Kind;
+    using Check = bool (*)(std::string_view);
+
+    // const members
+    Kind kind;
+    std::string_view name;
+
+private:
+    // mut members
+    std::string_view help_;
+    std::string_view longname_;
+    std::string_view metavar_;
+    Check check_;
+    char shortname_;
+    bool optional_;
+
+    // ctors
+    constexpr Spec(Kind kind, std::string_view name, Check check) :
+        kind(kind),
+        name(name),
+        help_(),
+        longname_(kind != Kind::Arg ? name : std::string_view()),
+        metavar_(),
+        check_(check),
+        shortname_('\0'),
+        optional_(false) {
+        if (name.empty())
+            throw std::invalid_argument("invalid name");
+        if (kind != Kind::Arg && !detail::isLongname(name))
+            throw std::invalid_argument("invalid longname");
+    }
+
+public:
+    // factories
+    static constexpr Spec flag(std::string_view name) {
+        return Spec(Kind::Flag, name, nullptr);
+    }
+
+    template <typename T = std::string>
+    static constexpr Spec opt(std::string_view name) {
+        return Spec(Kind::Opt, name, &detail::accepts<T>);
+    }
+
+    template <typename T = std::string>
+    static constexpr Spec arg(std::string_view name) {
+        return Spec(Kind::Arg, name, &detail::accepts<T>);
+    }
+
+    // builders
+    constexpr Spec &help(std::string_view s) {
+        this->help_ = s;
+        return *this;
+    }
+
+    constexpr Spec &longname(std::string_view s) {
+        if (this->kind == Kind::Arg || !detail::isLongname(s))
+            throw std::invalid_argument("invalid longname");
+        this->longname_ = s;
+        return *this;
+    }
+
+    constexpr Spec &shortname(char c) {
+        bool alnum = ('0' <= c && c <= '9') || ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z');
+        if (this->kind == Kind::Arg || !alnum)
+            throw std::invalid_argument("invalid shortname");
+        this->shortname_ = c;
+        return *this;
+    }
+
+    constexpr Spec &metavar(std::string_view s) {
+        this->metavar_ = s;
+        return *this;
+    }
+
+    constexpr Spec &optional(bool b) {
+        this->optional_ = b;
+        return *this;
+    }
+
+    // accessors
+    constexpr std::string_view help() const {
+        return this->help_;
+    }
+
+    constexpr std::string_view longname() const {
+        return this->longname_;
+    }
+
+    constexpr char shortname() const {
+        return this->shortname_;
+    }
+
+    // Metavar, if set (otherwise derived from the name, as by `Parser`)
+    constexpr std::string_view metavar() const {
+        return this->metavar_;
+    }
+
+    constexpr bool optional() const {
+        return this->optional_;
+    }
+
+    // Check a value is valid for this param
+    bool check(std::string_view s) const {
+        return !this->check_ || this->check_(s);
+    }
+};
+
+// class Matches<N>
+// Result of parsing against a `Schema<N>`.
+//
+// Values are views into the parsed `argv` (or into response files, which are kept mapped for the
+// lifetime of the matches), so no allocation takes place unless response files are read. They
+// have already been checked against their spec's type, so converting them cannot fail.
+template <std::size_t N>
+class Matches final {
+private:
+    // impl members
+    std::array<unsigned int, N> counts;
+    std::array<std::string_view, N> values;
+    std::vector<std::unique_ptr<FileSource>> files;
+
+public:
+    // ctors
+    Matches() : counts(), values(), files() {}
+
+    // accessors
+    unsigned int count(std::size_t i) const {
+        return this->counts[i];
+    }
+
+    std::string_view value(std::size_t i) const {
+        return this->values[i];
+    }
+
+    // Value converted into a `T` (or `T()` if unmatched)
+    template <typename T>
+    T get(std::size_t i) const {
+        T value{};
+        if (!this->values[i].empty())
+            convert(this->values[i], value);
+        return value;
+    }
+
+    // friends
+    template <std::size_t M>
+    friend class Schema;
+};
+
+namespace detail {
+
+// Non-template view of a `Schema<N>`, used by the parse engine
+struct SchemaView {
+    std::span<const Spec> specs;
+    std::span<const std::uint32_t> shortnames;
+    std::span<const std::uint32_t> disps;
+    std::span<const std::uint32_t> table;
+};
+
+// Parse `tokens` against `schema`, filling `counts` and `values`
+Expected<void> parse(const SchemaView &schema,
+                     const App &app,
+                     Tokens &tokens,
+                     unsigned int *counts,
+                     std::string_view *values);
+// Print help or version, or report an error, then exit
+[[noreturn]] void exit(const SchemaView &schema, const App &app, const Error &error);
+
+} // namespace detail
+
+// class Schema<N>
+// Compile-time option table.
+//
+// Declaring a `constexpr` schema builds a perfect hash over its longnames and a direct table over
+// its shortnames during compilation, so parsing performs no allocation and no setup. Tokens are
+// read and matched as by `Parser` (including response files, `--help` and `--version`), with the
+// same errors.
+template <std::size_t N>
+class Schema final {
+public:
+    // constants
+    static constexpr std::size_t npos = hash::EMPTY;
+
+private:
+    // impl members
+    std::array<Spec, N> specs;
+    std::array<std::uint32_t, 256> shortnames;
+    std::array<std::uint32_t, hash::buckets(N)> disps;
+    std::array<std::uint32_t, hash::slots(N)> table;
+
+public:
+    // ctors
+    constexpr Schema(const std::array<Spec, N> &specs) :
+        specs(specs),
+        shortnames(),
+        disps(),
+        table() {
+        // Ensure no name collisions
+        std::array<std::uint64_t, N> hashes{};
+        std::array<std::uint32_t, N> order{};
+        std::array<std::string_view, N> keys{};
+        for (std::size_t i = 0; i < N; i++)
+            keys[i] = specs[i].name;
+        if (hash::duplicate(keys, hashes, order) != N)
+            throw std::invalid_argument("duplicate name");
+        for (std::size_t i = 0; i < N; i++)
+            keys[i] = specs[i].longname();
+        if (hash::duplicate(keys, hashes, order) != N)
+            throw std::invalid_argument("duplicate longname");
+
+        // Fill shortname table
+        this->shortnames.fill(npos);
+        for (std::size_t i = 0; i < N; i++) {
+            auto c = static_cast<unsigned char>(specs[i].shortname());
+            if (!c)
+                continue;
+            if (this->shortnames[c] != npos)
+                throw std::invalid_argument("duplicate shortname");
+            this->shortnames[c] = i;
+        }
+
+        // Build longname perfect hash
+        std::array<std::uint32_t, hash::scratch(N)> tmp{};
+        if (!hash::build(keys, this->disps, this->table, tmp))
+            throw std::invalid_argument("unable to hash longnames");
+    }
+
+    // accessors
+    constexpr std::size_t size() const {
+        return N;
+    }
+
+    constexpr const Spec &operator[](std::size_t i) const {
+        return this->specs[i];
+    }
+
+    // Index of the param called `name`
+    consteval std::size_t index(std::string_view name) const {
+        for (std::size_t i = 0; i < N; i++)
+            if (this->specs[i].name == name)
+                return i;
+        throw std::invalid_argument("unknown name");
+    }
+
+    // Index of the option with this longname (or `npos`)
+    constexpr std::size_t find(std::string_view longname) const {
+        if (longname.empty())
+            return npos;
+        std::uint64_t h = hash::fnv1a(longname);
+        std::uint32_t i = this->table[hash::slot(h, this->disps, this->table.size())];
+        return (i != npos && this->specs[i].longname() == longname) ? i : npos;
+    }
+
+    // Index of the option with this shortname (or `npos`)
+    constexpr std::size_t find(char shortname) const {
+        return this->shortnames[static_cast<unsigned char>(shortname)];
+    }
+
+    // methods
+    // Parse, printing help or errors and exiting where needed
+    Matches<N> parse(const App &app, int argc, const char *const *argv) const {
+        auto matches = this->tryParse(app, argc, argv);
+        if (!matches)
+            detail::exit(this->view(), app, matches.error());
+        return std::move(matches.value());
+    }
+
+    // Parse without exiting, reporting help, version and errors as an `Error`
+    Expected<Matches<N>> tryParse(const App &app, int argc, const char *const *argv) const {
+        Matches<N> matches;
+        ArgvSource source(argc - 1, argv + 1);
+        Tokens tokens(source);
+        auto status = detail::parse(
+            this->view(), app, tokens, matches.counts.data(), matches.values.data());
+        if (!status)
+            return status.error();
+        matches.files = tokens.release();
+        return matches;
+    }
+
+private:
+    // helpers
+    detail::SchemaView view() const {
+        return detail::SchemaView{this->specs, this->shortnames, this->disps, this->table};
+    }
+};
+
+namespace detail {
+
+// Single-character views for every `char`
+inline constexpr auto CHARS = [] {
+    std::array<char, 256> chars{};
+    for (std::size_t i = 0; i < chars.size(); i++)
+        chars[i] = static_cast<char>(i);
+    return chars;
+}();
+
+// Check specs for duplicate keys
+template <typename Specs>
+constexpr bool unique(const Specs &specs, std::string_view (*key)(const Spec &)) {
+    std::array<std::string_view, std::tuple_size_v<Specs>> keys{};
+    std::array<std::uint64_t, std::tuple_size_v<Specs>> hashes{};
+    std::array<std::uint32_t, std::tuple_size_v<Specs>> order{};
+    for (std::size_t i = 0; i < keys.size(); i++)
+        keys[i] = key(specs[i]);
+    return hash::duplicate(keys, hashes, order) == keys.size();
+}
+
+} // namespace detail
+
+// Build a schema from a function returning its specs
+//
+// Name collisions are reported through `static_assert`:
+//
+//     constexpr auto schema = clip::schema([] {
+//         return std::array{
+//             clip::Spec::flag("verbose").shortname('v').help("Set verbosity level."),
+//             clip::Spec::opt<int>("repeat").shortname('n').metavar("INT"),
+//             clip::Spec::arg<double>("delay"),
+//         };
+//     });
+template <typename F>
+consteval auto schema(F) {
+    constexpr auto specs = F()();
+    static_assert(detail::unique(specs, [](const Spec &spec) { return spec.name; }),
+                  "clip: duplicate param name in schema");
+    static_assert(detail::unique(specs, [](const Spec &spec) { return spec.longname(); }),
+                  "clip: duplicate longname in schema");
+    static_assert(detail::unique(specs,
+                                 [](const Spec &spec) {
+                                     auto c = static_cast<unsigned char>(spec.shortname());
+                                     return c ? std::string_view(&detail::CHARS[c], 1) :
+                                                std::string_view();
+                                 }),
+                  "clip: duplicate shortname in schema");
+    return Schema<specs.size()>(specs);
+}
+
+} // namespace clip
@@ -0,0 +1,132 @@
+//
+//  stats.h
+//  Command line interface parse statistics.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace clip {
+
+// class Stats
+// Time spent and work done by a parser (and its results).
+//
+// Collected only when the library, and code including its headers, is built with `CLIP_STATS`
+// defined (as by `CPPFLAGS=-DCLIP_STATS make`); otherwise instrumentation compiles to nothing and
+// every field remains zero. In such builds, setting `CLIP_TRACE=<path>` (or passing
+// `--clip-trace=<path>` as the first argument) also records a span for each registration, freeze,
+// parse and help rendering, written as a Chrome trace (for `chrome://tracing` or Perfetto) at exit.
+struct Stats {
+    // phases (in nanoseconds)
+    std::uint64_t add;       // registering params
+    std::uint64_t freeze;    // indexing names and laying out results
+    std::uint64_t parse;     // parsing, including each of the following
+    std::uint64_t tokenize;  // reading tokens (and response files)
+    std::uint64_t lookup;    // matching names
+    std::uint64_t convert;   // converting values
+    std::uint64_t autoflags; // handling help and version
+    std::uint64_t help;      // rendering help
+
+    // counters
+    std::uint64_t params;
+    std::uint64_t tokens;
+    std::uint64_t lookups;
+    std::uint64_t conversions;
+    std::uint64_t strings; // allocated for text and help
+    std::uint64_t bytes;   // allocated for params, text, results and help
+};
+
+#ifdef CLIP_STATS
+namespace stats {
+
+using Clock = std::chrono::steady_clock;
+
+// Stats of the parser in use on this thread (or null)
+extern thread_local Stats *current;
+
+// Add to a counter of the current stats
+void count(std::uint64_t Stats::*field, std::uint64_t n);
+
+// Record a span for the trace (if enabled)
+void trace(const char *name, Clock::time_point start, Clock::time_point end);
+
+// Enable the trace, writing it to `path` at exit
+void output(const char *path);
+
+// class Scope
+// Directs instrumentation to a parser's stats for its lifetime.
+class Scope final {
+private:
+    // impl members
+    Stats *prev;
+
+public:
+    // ctors
+    Scope(Stats &stats) : prev(current) {
+        current = &stats;
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    // dtor
+    ~Scope() {
+        current = this->prev;
+    }
+};
+
+// class Timer
+// Adds its lifetime to a phase of the current stats (tracing it if named).
+class Timer final {
+private:
+    // impl members
+    std::uint64_t Stats::*field;
+    const char *name;
+    Clock::time_point start;
+
+public:
+    // ctors
+    Timer(std::uint64_t Stats::*field, const char *name = nullptr) :
+        field(field),
+        name(name),
+        start(Clock::now()) {}
+    Timer(const Timer &) = delete;
+    Timer &operator=(const Timer &) = delete;
+
+    // dtor
+    ~Timer() {
+        Clock::time_point end = Clock::now();
+        count(this->field, std::chrono::nanoseconds(end - this->start).count());
+        if (this->name)
+            trace(this->name, this->start, end);
+    }
+};
+
+} // namespace stats
+
+// Instrumentation (compiled to nothing without `CLIP_STATS`)
+#define CLIP_STATS_CAT_(a, b) a##b
+#define CLIP_STATS_CAT(a, b) CLIP_STATS_CAT_(a, b)
+#define CLIP_STATS_SCOPE(target) \
+    ::clip::stats::Scope CLIP_STATS_CAT(clip_stats_scope_, __LINE__)(target)
+#define CLIP_STATS_TIME(field) \
+    ::clip::stats::Timer CLIP_STATS_CAT(clip_stats_timer_, __LINE__)(&::clip::Stats::field)
+#define CLIP_STATS_SPAN(field) \
+    ::clip::stats::Timer CLIP_STATS_CAT(clip_stats_timer_, __LINE__)(&::clip::Stats::field, #field)
+#define CLIP_STATS_COUNT(field, n) ::clip::stats::count(&::clip::Stats::field, n)
+#define CLIP_STATS_OUTPUT(path) ::clip::stats::output(path)
+#else
+#define CLIP_STATS_SCOPE(target)
+#define CLIP_STATS_TIME(field)
+#define CLIP_STATS_SPAN(field)
+#define CLIP_STATS_COUNT(field, n)
+#define CLIP_STATS_OUTPUT(path)
+#endif
+
+} // namespace clip
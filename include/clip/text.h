@@ -0,0 +1,82 @@
+//
+//  text.h
+//  Command line interface text storage.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+namespace clip {
+
+// class Text
+// String that either owns its characters or borrows them from elsewhere.
+//
+// Borrowed text is either a caller's string (which must outlive it) or an arena owned by a
+// `Parser`, so copying it never allocates. Owned text copied within a `Text::Scope` is copied
+// straight into its arena.
+class Text final {
+public:
+    // class Scope
+    // Directs copies of owned text on this thread into an arena for its lifetime.
+    class Scope final {
+    private:
+        // impl members
+        std::pmr::memory_resource *prev;
+
+    public:
+        // ctors
+        Scope(std::pmr::memory_resource *mr);
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        // dtor
+        ~Scope();
+    };
+
+private:
+    // impl members
+    std::string owned;
+    std::string_view borrowed;
+
+    // arena of the current scope (if any)
+    static thread_local std::pmr::memory_resource *arena;
+
+public:
+    // ctors
+    Text();
+    Text(const char *s);
+    Text(const Text &other);
+    Text(Text &&) = default;
+
+    // operators
+    Text &operator=(const Text &) = default;
+    Text &operator=(Text &&) = default;
+
+    // builders
+    Text &assign(const char *s);
+    Text &assign(std::string &&s);
+    Text &borrow(const char *s);
+
+    // accessors
+    const char *data() const;
+    std::size_t size() const;
+    bool empty() const;
+
+    // methods
+    void intern(std::pmr::memory_resource *mr);
+
+private:
+    // helpers
+    void place(std::string_view s, std::pmr::memory_resource *mr);
+};
+
+} // namespace clip
@@ -0,0 +1,245 @@
+//
+//  token.h
+//  Command line interface token streams.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "clip/error.h"
+
+namespace clip {
+
+// class Source
+// Stream of command line tokens.
+//
+// A token must remain valid at least until the token after it has been read, as the parser holds
+// an option while reading its value.
+class Source {
+public:
+    // dtor
+    virtual ~Source() = 0;
+
+    // accessors
+    // Whether tokens remain valid for the lifetime of the source
+    virtual bool stable() const;
+
+    // methods (pure virtual)
+    // Read the next token, returning false once exhausted
+    virtual bool next(std::string_view &token) = 0;
+};
+
+// class ArgvSource
+// Tokens of an `argv` array.
+class ArgvSource final : public Source {
+private:
+    // impl members
+    const char *const *argv;
+    const char *const *end;
+
+public:
+    // ctors
+    ArgvSource(int argc, const char *const *argv);
+
+    // accessors
+    virtual bool stable() const override;
+
+    // methods
+    virtual bool next(std::string_view &token) override;
+};
+
+// class BufferSource
+// Tokens of a delimited buffer, such as `/proc/<pid>/cmdline`.
+//
+// A trailing delimiter does not produce an empty token. Tokens are views into the buffer.
+class BufferSource final : public Source {
+private:
+    // impl members
+    std::string_view buffer;
+    char delim;
+
+public:
+    // ctors
+    BufferSource(std::string_view buffer, char delim = '\0');
+
+    // accessors
+    virtual bool stable() const override;
+
+    // methods
+    virtual bool next(std::string_view &token) override;
+};
+
+// class FdSource
+// Tokens of a delimited file descriptor (e.g. `find -print0` on a pipe), read incrementally.
+//
+// Memory is bounded by the largest token rather than the whole input: each token is assembled
+// into one of two alternating buffers, so it remains valid while the next token is read. A trailing
+// delimiter does not produce an empty token. Read errors throw `std::system_error`.
+class FdSource final : public Source {
+public:
+    // constants
+    static constexpr std::size_t CHUNK = 64 * 1024;
+
+private:
+    // impl members
+    int fd;
+    char delim;
+    std::vector<char> chunk;
+    std::size_t pos;
+    std::size_t len;
+    std::array<std::string, 2> tokens;
+    std::size_t which;
+    bool eof;
+
+public:
+    // ctors
+    FdSource(int fd, char delim = '\0');
+
+    // methods
+    virtual bool next(std::string_view &token) override;
+
+private:
+    // helpers
+    bool fill();
+};
+
+// class RangeSource<It, End>
+// Tokens of an iterator range of strings.
+//
+// Elements of forward ranges are viewed in place. Input ranges (such as `std::istream_iterator`)
+// may reuse their storage and ranges of temporaries have none, so their elements are first copied
+// into one of two alternating buffers.
+template <typename It, typename End = It>
+class RangeSource final : public Source {
+private:
+    // impl members
+    It it;
+    End end;
+    std::array<std::string, 2> tokens;
+    std::size_t which;
+
+public:
+    // ctors
+    RangeSource(It first, End last) : it(first), end(last), tokens(), which(0) {}
+
+    // accessors
+    virtual bool stable() const override {
+        return std::forward_iterator<It> && std::is_lvalue_reference_v<std::iter_reference_t<It>>;
+    }
+
+    // methods
+    virtual bool next(std::string_view &token) override {
+        if (this->it == this->end)
+            return false;
+        using Ref = std::iter_reference_t<It>;
+        if constexpr (std::forward_iterator<It> && std::is_lvalue_reference_v<Ref>) {
+            token = *this->it;
+        } else {
+            std::string &buffer = this->tokens[this->which ^= 1];
+            buffer.assign(std::string_view(*this->it));
+            token = buffer;
+        }
+        ++this->it;
+        return true;
+    }
+};
+
+// class FileSource
+// Tokens of a response file, read lazily from a private memory mapping.
+//
+// Tokens are separated by whitespace. Single quotes group characters literally, double quotes
+// group characters while allowing backslash escapes, and a backslash outside quotes escapes the
+// next character. Escapes are removed in place (only touched pages are copied), so tokens are
+// views into the mapping which remain valid for the lifetime of the source. Raw sources only find
+// token boundaries, leaving quotes and escapes intact.
+class FileSource final : public Source {
+private:
+    // impl members
+    char *data;
+    std::size_t size;
+    char *pos;
+    dev_t dev_;
+    ino_t ino_;
+    bool raw;
+
+public:
+    // ctors
+    FileSource(const char *path, bool raw = false);
+    FileSource(const FileSource &) = delete;
+    FileSource &operator=(const FileSource &) = delete;
+
+    // dtor
+    ~FileSource();
+
+    // accessors
+    bool same(const FileSource &other) const;
+    virtual bool stable() const override;
+
+    // methods
+    virtual bool next(std::string_view &token) override;
+};
+
+// class Tokens
+// Token stream that expands `@path` response files in place.
+//
+// A response file that cannot be opened is passed through as a literal token, as is every token
+// once expansion is stopped (e.g. after `--`). Nested response files are expanded up to `DEPTH`
+// levels; cycles and runaway nesting end the stream, leaving an error behind. Tokens remain valid
+// as long as their source guarantees, and the most recent token may be pushed back once.
+// Subcommands read on from their parent's stream (rather than wrapping it), so their own `--`
+// stops its expansion too.
+class Tokens final : public Source {
+public:
+    // constants
+    static constexpr std::size_t DEPTH = 16;
+
+private:
+    // impl members
+    Source &source;
+    std::vector<std::unique_ptr<FileSource>> files; // every file opened (kept mapped)
+    std::vector<FileSource *> stack;                // files being read (innermost last)
+    std::string_view last;
+    bool pending;
+    bool raw;
+    bool expanding;
+    std::optional<Error> error_;
+
+public:
+    // ctors
+    Tokens(Source &source, bool raw = false);
+
+    // accessors
+    const std::optional<Error> &error() const;
+    // Whether tokens remain valid for the lifetime of the stream (response files stay mapped)
+    virtual bool stable() const override;
+
+    // methods
+    virtual bool next(std::string_view &token) override;
+    void unget();
+    // Pass remaining tokens through literally
+    void verbatim();
+    // Take every response file opened, so that tokens read from them outlive the stream
+    std::vector<std::unique_ptr<FileSource>> release();
+
+private:
+    // helpers
+    bool expand(std::string_view path);
+};
+
+} // namespace clip
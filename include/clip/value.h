@@ -10,22 +10,38 @@
 
 #pragma once
 
-#include <string>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "clip/convert.h"
 #include "clip/param.h"
+#include "clip/text.h"
 
 namespace clip {
 
 // class AbstractValue
 class AbstractValue : public virtual Param {
 private:
+    // impl members
+    std::span<const std::string_view> choices_;
+
     // mut members
-    std::string metavar_;
+    Text metavar_;
     bool optional_;
 
 public:
     // ctors
-    AbstractValue(const char *name);
+    AbstractValue(const char *name, std::span<const std::string_view> choices = {});
+    AbstractValue(const AbstractValue &) = default;
+    AbstractValue(AbstractValue &&) = default;
 
     // dtor
     virtual ~AbstractValue() = 0;
@@ -39,29 +55,100 @@ public:
     // accessors
     virtual const char *metavar() const final;
     virtual bool optional() const final;
+    // Names accepted by the value's `ValueTraits` (if restricted to a `Choices` table)
+    std::span<const std::string_view> choices() const;
     // accessors (using)
     using Param::help;
 
+    // accessors (pure virtual)
+    virtual bool repeated() const = 0;
+
+    // methods
+    void intern(std::pmr::memory_resource *mr);
     // methods (pure virtual)
-    virtual bool parse(const char *s) = 0;
+    virtual bool parse(std::string_view s) = 0;
+    virtual void reserve(std::size_t n) = 0;
+    virtual void finish() = 0;
+    virtual void reset() = 0;
+};
+
+// class Set<T>
+// Sorted, duplicate-free values held in a flat vector.
+template <typename T>
+class Set final : public std::vector<T> {
+public:
+    // ctors
+    using std::vector<T>::vector;
+};
+
+namespace detail {
+
+// Element type of repeated values (`void` otherwise)
+template <typename T>
+struct Element {
+    using type = void;
+};
+
+template <typename T>
+struct Element<std::vector<T>> {
+    using type = T;
+};
+
+template <typename T>
+struct Element<Set<T>> {
+    using type = T;
 };
 
+template <typename T>
+constexpr bool REPEATED = !std::is_void_v<typename Element<T>::type>;
+
+// Type converted for values of type `T` (its elements, when repeated)
+template <typename T>
+using Scalar = std::conditional_t<REPEATED<T>, typename Element<T>::type, T>;
+
+// Names accepted for values of type `T` (or its elements), if restricted
+template <typename T>
+constexpr std::span<const std::string_view> choices() {
+    using E = Scalar<T>;
+    if constexpr (requires { ValueTraits<E>::choices(); })
+        return ValueTraits<E>::choices();
+    else
+        return {};
+}
+
+} // namespace detail
+
 // class Value<T>
+// A param's value, converted through `ValueTraits<T>` (or of its elements when repeated).
 template <typename T>
 class Value : public virtual AbstractValue {
 private:
     // impl members
     T value_;
+    T default_;
+
+    // mut members
+    T *bind_;
+    detail::Scalar<T> lo_;
+    detail::Scalar<T> hi_;
+    bool ranged_;
 
 public:
     // ctors
     Value(const char *name);
+    Value(const Value &) = default;
+    Value(Value &&) = default;
 
     // dtor
     virtual ~Value() = 0;
 
     // builders
     virtual Value<T> &value(const T &value);
+    // Store the value in `target` whenever a parse is published
+    virtual Value<T> &bind(T *target);
+    // Reject parsed values (or elements) outside of `[lo, hi]`
+    Value<T> &range(const detail::Scalar<T> &lo, const detail::Scalar<T> &hi)
+        requires std::totally_ordered<detail::Scalar<T>>;
     // builders (override)
     virtual Value<T> &help(const char *s) override;
     virtual Value<T> &metavar(const char *s) override;
@@ -69,13 +156,202 @@ public:
 
     // accessors
     virtual const T &value() const final;
+    virtual bool repeated() const final override;
+    virtual const T &initial() const final;
+    virtual T *bind() const final;
+    bool ranged() const;
+    // Whether `value` (or each of its elements) lies within range
+    bool within(const T &value) const;
     // accessors (using)
     using AbstractValue::help;
     using AbstractValue::metavar;
     using AbstractValue::optional;
 
     // methods
-    virtual bool parse(const char *s) final override;
+    virtual bool parse(std::string_view s) final override;
+    virtual void reserve(std::size_t n) final override;
+    virtual void finish() final override;
+    virtual void reset() override;
+    void swap(T &value);
+
+    // methods (static)
+    // Operate on a value held outside of any param (e.g. within a `Result`)
+    static bool parse(T &value, std::string_view s);
+    // Drop any default ahead of the first parsed element
+    static void clear(T &value);
+    static void reserve(T &value, std::size_t n);
+    static void finish(T &value);
 };
 
+// class Value<T>
+// ctors
+template <typename T>
+Value<T>::Value(const char *name) :
+    Param(name),
+    AbstractValue(name, detail::choices<T>()),
+    value_(),
+    default_(),
+    bind_(nullptr),
+    lo_(),
+    hi_(),
+    ranged_(false) {}
+
+// dtor
+template <typename T>
+Value<T>::~Value() = default;
+
+// builders
+template <typename T>
+Value<T> &Value<T>::value(const T &value) {
+    this->value_ = value;
+    this->default_ = value;
+    return *this;
+}
+
+template <typename T>
+Value<T> &Value<T>::bind(T *target) {
+    this->bind_ = target;
+    return *this;
+}
+
+template <typename T>
+Value<T> &Value<T>::range(const detail::Scalar<T> &lo, const detail::Scalar<T> &hi)
+    requires std::totally_ordered<detail::Scalar<T>>
+{
+    // Ensure range is non-empty
+    if (hi < lo)
+        throw std::invalid_argument("invalid range");
+    this->lo_ = lo;
+    this->hi_ = hi;
+    this->ranged_ = true;
+    return *this;
+}
+
+// builders (override)
+template <typename T>
+Value<T> &Value<T>::help(const char *s) {
+    this->AbstractValue::help(s);
+    return *this;
+}
+
+template <typename T>
+Value<T> &Value<T>::metavar(const char *s) {
+    this->AbstractValue::metavar(s);
+    return *this;
+}
+
+template <typename T>
+Value<T> &Value<T>::optional(bool b) {
+    this->AbstractValue::optional(b);
+    return *this;
+}
+
+// accessors
+template <typename T>
+const T &Value<T>::value() const {
+    return this->value_;
+}
+
+template <typename T>
+bool Value<T>::repeated() const {
+    return detail::REPEATED<T>;
+}
+
+template <typename T>
+const T &Value<T>::initial() const {
+    return this->default_;
+}
+
+template <typename T>
+T *Value<T>::bind() const {
+    return this->bind_;
+}
+
+template <typename T>
+bool Value<T>::ranged() const {
+    return this->ranged_;
+}
+
+template <typename T>
+bool Value<T>::within(const T &value) const {
+    if constexpr (std::totally_ordered<detail::Scalar<T>>) {
+        auto in = [this](const detail::Scalar<T> &x) {
+            return !(x < this->lo_) && !(this->hi_ < x);
+        };
+        if (!this->ranged_)
+            return true;
+        if constexpr (detail::REPEATED<T>)
+            return std::all_of(value.begin(), value.end(), in);
+        else
+            return in(value);
+    } else {
+        return true;
+    }
+}
+
+// methods
+template <typename T>
+bool Value<T>::parse(std::string_view s) {
+    return Value<T>::parse(this->value_, s);
+}
+
+template <typename T>
+void Value<T>::reserve(std::size_t n) {
+    Value<T>::reserve(this->value_, n);
+}
+
+template <typename T>
+void Value<T>::finish() {
+    Value<T>::finish(this->value_);
+}
+
+template <typename T>
+void Value<T>::reset() {
+    this->value_ = this->default_; // reuses existing capacity
+}
+
+template <typename T>
+void Value<T>::swap(T &value) {
+    using std::swap;
+    swap(this->value_, value);
+}
+
+// methods (static)
+template <typename T>
+bool Value<T>::parse(T &value, std::string_view s) {
+    if constexpr (detail::REPEATED<T>) {
+        // Append each parsed element
+        typename detail::Element<T>::type element;
+        bool success = convert(s, element);
+        if (success)
+            value.push_back(std::move(element));
+        return success;
+    } else {
+        return convert(s, value);
+    }
+}
+
+template <typename T>
+void Value<T>::clear(T &value) {
+    // Parsed elements replace any default
+    if constexpr (detail::REPEATED<T>)
+        value.clear();
+}
+
+template <typename T>
+void Value<T>::reserve(T &value, std::size_t n) {
+    // Make room for parsed elements (beyond any default)
+    if constexpr (detail::REPEATED<T>)
+        value.reserve(std::max(n, value.size()));
+}
+
+template <typename T>
+void Value<T>::finish(T &value) {
+    // Sort and dedupe sets
+    if constexpr (std::is_same_v<T, Set<typename detail::Element<T>::type>>) {
+        std::sort(value.begin(), value.end());
+        value.erase(std::unique(value.begin(), value.end()), value.end());
+    }
+}
+
 } // namespace clip
@@ -34,6 +34,16 @@ App &App::version(const char *s) {
     return *this;
 }
 
+App &App::env(const char *prefix) {
+    this->env_ = prefix;
+    return *this;
+}
+
+App &App::envargs(const char *var) {
+    this->envargs_ = var;
+    return *this;
+}
+
 // accessors
 const std::string &App::about() const {
     return this->about_;
@@ -47,4 +57,12 @@ const std::string &App::version() const {
     return this->version_;
 }
 
+const std::string &App::env() const {
+    return this->env_;
+}
+
+const std::string &App::envargs() const {
+    return this->envargs_;
+}
+
 } // namespace clip
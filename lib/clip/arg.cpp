@@ -10,8 +10,6 @@
 
 #include "clip/arg.h"
 
-#include <string>
-
 #include "clip/param.h"
 #include "clip/value.h"
 
@@ -40,43 +38,4 @@ AbstractArg &AbstractArg::optional(bool b) {
     return *this;
 }
 
-// class Arg<T>
-// ctors
-template <typename T>
-Arg<T>::Arg(const char *name) :
-    Param(name),
-    AbstractValue(name),
-    AbstractArg(name),
-    Value<T>(name) {}
-
-// builders (override)
-template <typename T>
-Arg<T> &Arg<T>::help(const char *s) {
-    this->AbstractArg::help(s);
-    return *this;
-}
-
-template <typename T>
-Arg<T> &Arg<T>::metavar(const char *s) {
-    this->AbstractArg::metavar(s);
-    return *this;
-}
-
-template <typename T>
-Arg<T> &Arg<T>::optional(bool b) {
-    this->AbstractArg::optional(b);
-    return *this;
-}
-
-template <typename T>
-Arg<T> &Arg<T>::value(const T &v) {
-    this->Value<T>::value(v);
-    return *this;
-}
-
-// explicit instantiations
-template class Arg<double>;
-template class Arg<int>;
-template class Arg<std::string>;
-
 } // namespace clip
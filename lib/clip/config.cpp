@@ -0,0 +1,267 @@
+//
+//  config.cpp
+//  Command line interface config files.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include "clip/config.h"
+
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "clip/error.h"
+
+namespace clip {
+
+namespace {
+
+// Check for whitespace within a line
+constexpr bool space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Skip whitespace up to the end of a line
+char *skip(char *p, const char *eol) {
+    while (p < eol && space(*p))
+        p++;
+    return p;
+}
+
+// View a range without surrounding whitespace
+std::string_view trim(char *first, char *last) {
+    first = skip(first, last);
+    while (last > first && space(last[-1]))
+        last--;
+    return std::string_view(first, last - first);
+}
+
+} // namespace
+
+// class ConfigFile
+// ctors
+ConfigFile::ConfigFile(const char *path) :
+    path(path),
+    data(nullptr),
+    size(0),
+    pos(nullptr),
+    cursor(nullptr),
+    eol(nullptr),
+    line(0),
+    key(),
+    buffer(),
+    prefix(0),
+    error_() {
+    // Open file
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), path);
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), path);
+    }
+    this->size = st.st_size;
+
+    // Map file privately (unescaping writes only touch our copy)
+    if (this->size) {
+        void *map = ::mmap(nullptr, this->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), path);
+        }
+        ::madvise(map, this->size, MADV_SEQUENTIAL);
+        this->data = static_cast<char *>(map);
+    }
+    this->pos = this->data;
+    ::close(fd);
+}
+
+// dtor
+ConfigFile::~ConfigFile() {
+    if (this->data)
+        ::munmap(this->data, this->size);
+}
+
+// accessors
+const std::optional<Error> &ConfigFile::error() const {
+    return this->error_;
+}
+
+// methods
+bool ConfigFile::next(Entry &entry) {
+    // Continue an array
+    if (this->cursor && this->element(entry))
+        return true;
+
+    // Read each line until the next entry
+    char *end = this->data + this->size;
+    while (!this->error_ && this->pos < end) {
+        // Find the end of the line
+        char *p = this->pos;
+        auto *nl = static_cast<char *>(std::memchr(p, '\n', end - p));
+        this->eol = nl ? nl : end;
+        this->pos = nl ? nl + 1 : end;
+        this->line++;
+
+        // Skip blank lines and comments
+        p = skip(p, this->eol);
+        if (p == this->eol || *p == '#' || *p == ';')
+            continue;
+
+        // Parse section headers
+        if (*p == '[') {
+            auto *close = static_cast<char *>(std::memchr(p, ']', this->eol - p));
+            if (!close) {
+                this->error_ = this->fail(Errc::Config, "unterminated section");
+                return false;
+            }
+            std::string_view section = trim(p + 1, close);
+            this->buffer.assign(section).append(section.empty() ? 0 : 1, '-');
+            this->prefix = this->buffer.size();
+            if (!this->rest(close + 1))
+                return false;
+            continue;
+        }
+
+        // Parse key (prefixed by any section)
+        auto *eq = static_cast<char *>(std::memchr(p, '=', this->eol - p));
+        if (!eq) {
+            this->error_ = this->fail(Errc::Config, "expected `key = value`");
+            return false;
+        }
+        this->key = trim(p, eq);
+        if (this->key.empty()) {
+            this->error_ = this->fail(Errc::Config, "missing key");
+            return false;
+        }
+        if (this->prefix) {
+            // Copy key after the prefix (reallocating only for the longest key yet)
+            std::size_t len = this->prefix + this->key.size();
+            if (this->buffer.size() < len)
+                this->buffer.resize(len);
+            std::memcpy(this->buffer.data() + this->prefix, this->key.data(), this->key.size());
+            this->key = std::string_view(this->buffer.data(), len);
+        }
+
+        // Parse value (or the first element of an array)
+        p = skip(eq + 1, this->eol);
+        if (p < this->eol && *p == '[') {
+            this->cursor = p + 1;
+            if (this->element(entry))
+                return true;
+            continue; // empty array
+        }
+        entry.key = this->key;
+        entry.line = this->line;
+        return this->scalar(p, entry.value, false) && this->rest(p);
+    }
+
+    return false;
+}
+
+Error ConfigFile::fail(Errc code, std::string_view msg) const {
+    return Error{code, fmt::format("{}:{}: {}", this->path, this->line, msg)};
+}
+
+// helpers
+bool ConfigFile::element(Entry &entry) {
+    // Check for the end of the array
+    char *p = skip(this->cursor, this->eol);
+    this->cursor = nullptr;
+    if (p < this->eol && *p == ']') {
+        this->rest(p + 1);
+        return false;
+    }
+
+    // Parse element, followed by a separator
+    entry.key = this->key;
+    entry.line = this->line;
+    if (!this->scalar(p, entry.value, true))
+        return false;
+    p = skip(p, this->eol);
+    if (p < this->eol && *p == ',') {
+        p++;
+    } else if (p == this->eol || *p != ']') {
+        this->error_ = this->fail(Errc::Config, "unterminated array");
+        return false;
+    }
+    this->cursor = p;
+    return true;
+}
+
+bool ConfigFile::scalar(char *&p, std::string_view &value, bool array) {
+    // Parse quoted strings, compacting unescaped characters towards their start
+    if (p < this->eol && (*p == '"' || *p == '\'')) {
+        char quote = *p++;
+        char *start = p;
+        char *out = p;
+        for (; p < this->eol && *p != quote; p++) {
+            char c = *p;
+            if (c == '\\' && quote == '"' && p + 1 < this->eol) {
+                // clang-format off
+                switch (c = *++p) {
+                    case 'n': c = '\n'; break;
+                    case 'r': c = '\r'; break;
+                    case 't': c = '\t'; break;
+                }
+                // clang-format on
+            }
+            // Only write once characters have shifted (avoids copying clean pages)
+            if (out != p)
+                *out = c;
+            out++;
+        }
+        if (p == this->eol) {
+            this->error_ = this->fail(Errc::Config, "unterminated string");
+            return false;
+        }
+        value = std::string_view(start, out - start);
+        p++; // skip closing quote
+        return true;
+    }
+
+    // Parse bare values up to an inline comment (or the end of an array element)
+    char *start = p;
+    if (array) {
+        while (p < this->eol && *p != ',' && *p != ']' && *p != '#')
+            p++;
+    } else {
+        // Search for comments a block at a time
+        p = this->eol;
+        for (char *q = start; (q = static_cast<char *>(std::memchr(q, '#', this->eol - q))); q++)
+            if (q == start || space(q[-1])) {
+                p = q;
+                break;
+            }
+    }
+    value = trim(start, p);
+    return true;
+}
+
+bool ConfigFile::rest(char *p) {
+    // Allow only a trailing comment
+    p = skip(p, this->eol);
+    if (p == this->eol || *p == '#' || *p == ';')
+        return true;
+    this->error_ = this->fail(Errc::Config, fmt::format("unexpected `{}`", trim(p, this->eol)));
+    return false;
+}
+
+} // namespace clip
@@ -0,0 +1,177 @@
+//
+//  constraint.cpp
+//  Command line interface param constraints.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include "clip/constraint.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace clip {
+
+namespace {
+
+using Word = Constraints::Word;
+constexpr std::size_t BITS = Constraints::BITS;
+
+// Set bit `idx` within a bitset
+void set(std::vector<Word> &bits, std::size_t idx) {
+    bits[idx / BITS] |= Word(1) << (idx % BITS);
+}
+
+// Index of the lowest set bit within word `w`
+std::size_t lowest(std::size_t w, Word word) {
+    return w * BITS + std::countr_zero(word);
+}
+
+} // namespace
+
+// class Constraints
+// ctors
+Constraints::Constraints() :
+    nwords(0),
+    required(),
+    ranged(),
+    related(),
+    conflicts(),
+    needs(),
+    members(),
+    groups() {}
+
+// mutators
+void Constraints::clear(std::size_t n) {
+    this->nwords = (n + BITS - 1) / BITS;
+    this->required.assign(this->nwords, 0);
+    this->ranged.assign(this->nwords, 0);
+    this->related.assign(this->nwords, 0);
+    for (Sparse *sparse : {&this->conflicts, &this->needs, &this->members}) {
+        sparse->offsets.assign(1, 0);
+        sparse->entries.clear();
+        sparse->pending.clear();
+    }
+    this->conflicts.offsets.resize(n + 1);
+    this->needs.offsets.resize(n + 1);
+    this->groups.clear();
+}
+
+void Constraints::require(std::size_t idx) {
+    set(this->required, idx);
+}
+
+void Constraints::range(std::size_t idx) {
+    set(this->ranged, idx);
+}
+
+void Constraints::conflict(std::size_t idx, std::size_t other) {
+    set(this->related, idx);
+    this->conflicts.pending.emplace_back(idx, other);
+}
+
+void Constraints::need(std::size_t idx, std::size_t other) {
+    set(this->related, idx);
+    this->needs.pending.emplace_back(idx, other);
+}
+
+void Constraints::group(Rule rule, std::span<const std::size_t> slots) {
+    for (std::size_t idx : slots)
+        this->members.pending.emplace_back(this->groups.size(), idx);
+    this->groups.push_back(rule);
+    this->members.offsets.push_back(0);
+}
+
+void Constraints::build() {
+    for (Sparse *sparse : {&this->conflicts, &this->needs, &this->members}) {
+        // Sort bits by row, merging those sharing a word
+        auto &pending = sparse->pending;
+        std::sort(pending.begin(), pending.end());
+        sparse->entries.clear();
+        std::fill(sparse->offsets.begin(), sparse->offsets.end(), 0);
+        std::size_t row = 0;
+        for (std::size_t i = 0; i < pending.size(); i++) {
+            auto [r, bit] = pending[i];
+            auto word = static_cast<std::uint32_t>(bit / BITS);
+            // Close rows up to this one
+            for (; row < r; row++)
+                sparse->offsets[row + 1] = sparse->entries.size();
+            if (i && pending[i - 1].first == r && sparse->entries.back().first == word)
+                sparse->entries.back().second |= Word(1) << (bit % BITS);
+            else
+                sparse->entries.emplace_back(word, Word(1) << (bit % BITS));
+        }
+        for (; row + 1 < sparse->offsets.size(); row++)
+            sparse->offsets[row + 1] = sparse->entries.size();
+    }
+}
+
+// accessors
+std::size_t Constraints::words() const {
+    return this->nwords;
+}
+
+bool Constraints::empty() const {
+    auto none = [](const std::vector<Word> &bits) {
+        return std::all_of(bits.begin(), bits.end(), [](Word word) { return !word; });
+    };
+    return none(this->required) && none(this->ranged) && none(this->related) &&
+           this->groups.empty();
+}
+
+std::span<const Word> Constraints::ranges() const {
+    return this->ranged;
+}
+
+std::vector<std::size_t> Constraints::group(std::size_t idx) const {
+    std::vector<std::size_t> slots;
+    for (std::size_t i = this->members.offsets[idx]; i < this->members.offsets[idx + 1]; i++)
+        for (auto [w, bits] = this->members.entries[i]; bits; bits &= bits - 1)
+            slots.push_back(lowest(w, bits));
+    return slots;
+}
+
+// methods
+Constraints::Violation Constraints::check(const Word *matched) const {
+    // Check required slots
+    for (std::size_t w = 0; w < this->nwords; w++)
+        if (Word missing = this->required[w] & ~matched[w])
+            return {Rule::Required, lowest(w, missing), 0};
+
+    // Check conflicts and needs of each matched slot having any
+    for (std::size_t w = 0; w < this->nwords; w++) {
+        for (Word bits = matched[w] & this->related[w]; bits; bits &= bits - 1) {
+            std::size_t idx = lowest(w, bits);
+            const Sparse &c = this->conflicts;
+            for (std::size_t i = c.offsets[idx]; i < c.offsets[idx + 1]; i++)
+                if (Word both = c.entries[i].second & matched[c.entries[i].first])
+                    return {Rule::Conflicts, idx, lowest(c.entries[i].first, both)};
+            const Sparse &n = this->needs;
+            for (std::size_t i = n.offsets[idx]; i < n.offsets[idx + 1]; i++)
+                if (Word missing = n.entries[i].second & ~matched[n.entries[i].first])
+                    return {Rule::Needs, idx, lowest(n.entries[i].first, missing)};
+        }
+    }
+
+    // Check groups by counting their matched slots
+    const Sparse &m = this->members;
+    for (std::size_t g = 0; g < this->groups.size(); g++) {
+        std::size_t count = 0;
+        for (std::size_t i = m.offsets[g]; i < m.offsets[g + 1]; i++)
+            count += std::popcount(m.entries[i].second & matched[m.entries[i].first]);
+        if (this->groups[g] == Rule::AnyOf ? count == 0 : count != 1)
+            return {this->groups[g], g, count};
+    }
+
+    return {Rule::None, 0, 0};
+}
+
+} // namespace clip
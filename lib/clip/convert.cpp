@@ -0,0 +1,224 @@
+//
+//  convert.cpp
+//  Command line interface value conversion.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include "clip/convert.h"
+
+#include <charconv>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <system_error>
+
+namespace clip {
+
+namespace {
+
+// Intermediate precision for exact arithmetic
+using Wide = unsigned __int128;
+
+// Exact ratio between units
+struct Ratio {
+    unsigned long long num;
+    unsigned long long den;
+};
+
+// Split an optional sign from a string
+bool sign(std::string_view &s) {
+    bool negative = s.starts_with('-');
+    if (negative || s.starts_with('+'))
+        s.remove_prefix(1);
+    return negative;
+}
+
+// Parse an unsigned decimal (with optional fraction) as `mantissa / 10^scale`
+//
+// Consumes the number from `s`, leaving any suffix.
+bool decimal(std::string_view &s, Wide &mantissa, unsigned &scale) {
+    const char *first = s.data();
+    const char *last = first + s.size();
+    // Parse whole part
+    unsigned long long whole;
+    auto [p, ec] = std::from_chars(first, last, whole);
+    if (ec != std::errc())
+        return false;
+    mantissa = whole;
+    scale = 0;
+    // Parse fractional part (of at least one digit)
+    if (p != last && *p == '.') {
+        for (p++; p != last && '0' <= *p && *p <= '9'; p++) {
+            if (scale == std::numeric_limits<unsigned long long>::digits10)
+                return false; // too precise
+            mantissa = mantissa * 10 + (*p - '0');
+            scale++;
+        }
+        if (!scale)
+            return false; // bare point
+    }
+    s.remove_prefix(p - first);
+    return true;
+}
+
+// Scale `mantissa / 10^scale` by a ratio, requiring an exact result
+bool rescale(Wide mantissa, unsigned scale, Ratio ratio, Wide &result) {
+    // Skip wide division for plain integers
+    if (!scale && ratio.num == ratio.den) {
+        result = mantissa;
+        return true;
+    }
+    unsigned long long g = std::gcd(ratio.num, ratio.den);
+    Wide num = ratio.num / g;
+    Wide den = ratio.den / g;
+    for (unsigned i = 0; i < scale; i++)
+        den *= 10;
+    if (mantissa > std::numeric_limits<Wide>::max() / num)
+        return false; // overflow
+    Wide x = mantissa * num;
+    if (x % den)
+        return false; // inexact
+    result = x / den;
+    return true;
+}
+
+// Fit a wide magnitude within 64 bits
+bool fit(Wide wide, unsigned long long &magnitude) {
+    if (wide > std::numeric_limits<unsigned long long>::max())
+        return false;
+    magnitude = static_cast<unsigned long long>(wide);
+    return true;
+}
+
+// Ratio of a size suffix
+bool size(std::string_view suffix, Ratio &ratio) {
+    ratio = {1, 1};
+    if (suffix.empty() || suffix == "B")
+        return true;
+    // Find power
+    constexpr std::string_view PREFIXES = "KMGTPE";
+    std::size_t power = PREFIXES.find(suffix.front()) + 1;
+    if (!power)
+        return false;
+    suffix.remove_prefix(1);
+    // Find base
+    unsigned long long base;
+    if (suffix.empty() || suffix == "i" || suffix == "iB")
+        base = 1024;
+    else if (suffix == "B")
+        base = 1000;
+    else
+        return false;
+    for (std::size_t i = 0; i < power; i++)
+        ratio.num *= base;
+    return true;
+}
+
+// Ratio of a time suffix (in seconds)
+bool unit(std::string_view suffix, Ratio &ratio) {
+    // clang-format off
+    if      (suffix == "ns")                   ratio = {1, 1000000000};
+    else if (suffix == "us" || suffix == "µs") ratio = {1, 1000000};
+    else if (suffix == "ms")                   ratio = {1, 1000};
+    else if (suffix == "s")                    ratio = {1, 1};
+    else if (suffix == "m" || suffix == "min") ratio = {60, 1};
+    else if (suffix == "h")                    ratio = {3600, 1};
+    else if (suffix == "d")                    ratio = {86400, 1};
+    else                                       return false;
+    // clang-format on
+    return true;
+}
+
+// Parse a duration as `mantissa / 10^scale` units, each `ratio` ticks of `num / den` seconds
+bool span(std::string_view s,
+          unsigned long long num,
+          unsigned long long den,
+          Wide &mantissa,
+          unsigned &scale,
+          Ratio &ratio) {
+    if (!decimal(s, mantissa, scale))
+        return false;
+    ratio = {1, 1}; // bare numbers count ticks
+    if (!s.empty()) {
+        Ratio seconds;
+        if (!unit(s, seconds))
+            return false;
+        ratio = {seconds.num * den, seconds.den * num};
+    }
+    return true;
+}
+
+} // namespace
+
+namespace detail {
+
+bool integer(std::string_view s, unsigned long long &magnitude, bool &negative) {
+    negative = sign(s);
+
+    // Parse prefixed bases
+    int base = 0;
+    if (s.size() > 2 && s[0] == '0') {
+        // clang-format off
+        switch (s[1]) {
+            case 'x': case 'X': base = 16; break;
+            case 'o': case 'O': base = 8;  break;
+            case 'b': case 'B': base = 2;  break;
+        }
+        // clang-format on
+    }
+    if (base) {
+        const char *last = s.data() + s.size();
+        auto [p, ec] = std::from_chars(s.data() + 2, last, magnitude, base);
+        return ec == std::errc() && p == last;
+    }
+
+    // Parse decimals with size suffixes
+    Wide mantissa, wide;
+    unsigned scale;
+    Ratio ratio;
+    return decimal(s, mantissa, scale) && size(s, ratio) &&
+           rescale(mantissa, scale, ratio, wide) && fit(wide, magnitude);
+}
+
+bool duration(std::string_view s,
+              unsigned long long num,
+              unsigned long long den,
+              unsigned long long &magnitude,
+              bool &negative) {
+    negative = sign(s);
+
+    // Parse number and unit, then convert into ticks
+    Wide mantissa, ticks;
+    unsigned scale;
+    Ratio ratio;
+    return span(s, num, den, mantissa, scale, ratio) && rescale(mantissa, scale, ratio, ticks) &&
+           fit(ticks, magnitude);
+}
+
+bool duration(std::string_view s,
+              unsigned long long num,
+              unsigned long long den,
+              long double &ticks) {
+    bool negative = sign(s);
+
+    // Parse number and unit, then convert into (possibly fractional) ticks
+    Wide mantissa;
+    unsigned scale;
+    Ratio ratio;
+    if (!span(s, num, den, mantissa, scale, ratio))
+        return false;
+    ticks = static_cast<long double>(mantissa) * ratio.num / ratio.den;
+    for (unsigned i = 0; i < scale; i++)
+        ticks /= 10;
+    if (negative)
+        ticks = -ticks;
+    return true;
+}
+
+} // namespace detail
+
+} // namespace clip
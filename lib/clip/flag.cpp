@@ -17,7 +17,15 @@ namespace clip {
 
 // class Flag
 // ctors
-Flag::Flag(const char *name) : Param(name), Option(name) {}
+Flag::Flag(const char *name) : Param(name), Option(name), bind_(nullptr) {}
+
+Flag::Flag(const char *name, Borrowed tag) : Param(name, tag), Option(name), bind_(nullptr) {}
+
+// builders
+Flag &Flag::bind(unsigned int *target) {
+    this->bind_ = target;
+    return *this;
+}
 
 // builders (override)
 Flag &Flag::help(const char *s) {
@@ -35,4 +43,19 @@ Flag &Flag::shortname(char c) {
     return *this;
 }
 
+Flag &Flag::env(const char *s) {
+    this->Option::env(s);
+    return *this;
+}
+
+Flag &Flag::required(bool b) {
+    this->Option::required(b);
+    return *this;
+}
+
+// accessors
+unsigned int *Flag::bind() const {
+    return this->bind_;
+}
+
 } // namespace clip
@@ -0,0 +1,74 @@
+//
+//  index.cpp
+//  Command line interface lookup index.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include "clip/index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "clip/hash.h"
+
+namespace clip {
+
+// class Index
+// mutators
+void Index::clear() {
+    this->keys.clear();
+    this->values.clear();
+    this->disps.clear();
+    this->table.clear();
+}
+
+void Index::insert(std::string_view key, std::size_t value) {
+    // Invalidate any previous build
+    this->disps.clear();
+    this->table.clear();
+    this->keys.push_back(key);
+    this->values.push_back(value);
+}
+
+void Index::build() {
+    // Small indices are scanned linearly
+    const std::size_t n = this->keys.size();
+    if (n <= LINEAR)
+        return;
+
+    // Build perfect hash, growing the table until placement succeeds
+    std::vector<std::uint32_t> tmp(hash::scratch(n));
+    this->disps.assign(hash::buckets(n), 0);
+    for (std::size_t size = hash::slots(n);; size *= 2) {
+        this->table.assign(size, hash::EMPTY);
+        if (hash::build(this->keys, this->disps, this->table, tmp))
+            break;
+    }
+}
+
+// accessors
+std::size_t Index::size() const {
+    return this->keys.size();
+}
+
+std::size_t Index::find(std::string_view key) const {
+    // Scan small indices
+    if (this->table.empty()) {
+        for (std::size_t i = 0; i < this->keys.size(); i++)
+            if (this->keys[i] == key)
+                return this->values[i];
+        return npos;
+    }
+
+    // Probe perfect hash
+    std::uint32_t i = this->table[hash::slot(hash::fnv1a(key), this->disps, this->table.size())];
+    return (i != hash::EMPTY && this->keys[i] == key) ? this->values[i] : npos;
+}
+
+} // namespace clip
@@ -10,7 +10,9 @@
 
 #include "clip/opt.h"
 
-#include <string>
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
 
 #include "clip/option.h"
 #include "clip/param.h"
@@ -20,7 +22,7 @@ namespace clip {
 
 // class AbstractOpt
 // ctors
-AbstractOpt::AbstractOpt(const char *name) : AbstractValue(name), Option(name) {}
+AbstractOpt::AbstractOpt(const char *name) : AbstractValue(name), Option(name), nargs_(1) {}
 
 // dtor
 AbstractOpt::~AbstractOpt() = default;
@@ -41,65 +43,51 @@ AbstractOpt &AbstractOpt::shortname(char c) {
     return *this;
 }
 
-AbstractOpt &AbstractOpt::metavar(const char *s) {
-    this->AbstractValue::metavar(s);
+AbstractOpt &AbstractOpt::env(const char *s) {
+    this->Option::env(s);
     return *this;
 }
 
-AbstractOpt &AbstractOpt::optional(bool b) {
-    this->AbstractValue::optional(b);
+AbstractOpt &AbstractOpt::required(bool b) {
+    this->Option::required(b);
     return *this;
 }
 
-// class Opt<T>
-// ctors
-template <typename T>
-Opt<T>::Opt(const char *name) :
-    Param(name),
-    AbstractValue(name),
-    AbstractOpt(name),
-    Value<T>(name) {}
-
-// builders (override)
-template <typename T>
-Opt<T> &Opt<T>::help(const char *s) {
-    this->AbstractOpt::help(s);
-    return *this;
-}
-
-template <typename T>
-Opt<T> &Opt<T>::longname(const char *s) {
-    this->AbstractOpt::longname(s);
+AbstractOpt &AbstractOpt::metavar(const char *s) {
+    this->AbstractValue::metavar(s);
     return *this;
 }
 
-template <typename T>
-Opt<T> &Opt<T>::shortname(char c) {
-    this->AbstractOpt::shortname(c);
+AbstractOpt &AbstractOpt::optional(bool b) {
+    // Ensure nargs remains valid
+    if (b && this->nargs_ > 1)
+        throw std::invalid_argument("nargs requires a non-optional value");
+    this->AbstractValue::optional(b);
     return *this;
 }
 
-template <typename T>
-Opt<T> &Opt<T>::metavar(const char *s) {
-    this->AbstractOpt::metavar(s);
+// builders
+AbstractOpt &AbstractOpt::nargs(std::size_t n) {
+    // Ensure nargs is valid
+    if (!n)
+        throw std::invalid_argument("invalid nargs");
+    if (n > 1 && !this->repeated())
+        throw std::invalid_argument("nargs requires a repeated value");
+    if (n > 1 && this->optional())
+        throw std::invalid_argument("nargs requires a non-optional value");
+    this->nargs_ = n;
     return *this;
 }
 
-template <typename T>
-Opt<T> &Opt<T>::optional(bool b) {
-    this->AbstractOpt::optional(b);
-    return *this;
+// accessors
+std::size_t AbstractOpt::nargs() const {
+    return this->nargs_;
 }
 
-template <typename T>
-Opt<T> &Opt<T>::value(const T &v) {
-    this->Value<T>::value(v);
-    return *this;
+// methods
+void AbstractOpt::intern(std::pmr::memory_resource *mr) {
+    this->Option::intern(mr);
+    this->AbstractValue::intern(mr);
 }
 
-// explicit instantiations
-template class Opt<double>;
-template class Opt<int>;
-template class Opt<std::string>;
-
 } // namespace clip
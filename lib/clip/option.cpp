@@ -10,21 +10,39 @@
 
 #include "clip/option.h"
 
+#include <algorithm>
 #include <cctype>
-#include <regex>
+#include <memory_resource>
 #include <stdexcept>
-#include <string>
-#include <vector>
+#include <string_view>
 
 #include "clip/param.h"
 
 namespace clip {
 
+namespace {
+
+// Check a longname is valid (alphanumeric, then alphanumeric or hyphens)
+void checkLongname(std::string_view s) {
+    auto valid = [](unsigned char c) { return std::isalnum(c) || c == '-'; };
+    if (s.empty() || !std::isalnum(static_cast<unsigned char>(s.front()))
+        || !std::all_of(s.begin(), s.end(), valid))
+        throw std::invalid_argument("invalid longname");
+}
+
+} // namespace
+
 // class Option
 // ctors
-Option::Option(const char *name) : Param(name), longname_(""), shortname_('\0'), count_(0) {
-    // Set default longname
-    this->longname(name);
+Option::Option(const char *name) :
+    Param(name),
+    longname_(),
+    env_(),
+    shortname_('\0'),
+    required_(false),
+    count_(0) {
+    // Default longname to the name (sharing its text rather than copying it)
+    checkLongname(name);
 }
 
 // dtor
@@ -33,9 +51,11 @@ Option::~Option() = default;
 // builders
 Option &Option::longname(const char *s) {
     // Ensure longname is valid
-    if (!std::regex_match(name, std::regex("^[A-Za-z0-9][A-Za-z0-9-]*$")))
-        throw std::invalid_argument("invalid longname");
-    this->longname_ = std::string(s);
+    checkLongname(s);
+    if (this->borrow())
+        this->longname_.borrow(s);
+    else
+        this->longname_.assign(s);
     return *this;
 }
 
@@ -47,6 +67,23 @@ Option &Option::shortname(char c) {
     return *this;
 }
 
+Option &Option::env(const char *s) {
+    // Ensure environment variable name is valid
+    std::string_view sv(s);
+    if (sv.empty() || sv.find('=') != std::string_view::npos)
+        throw std::invalid_argument("invalid env");
+    if (this->borrow())
+        this->env_.borrow(s);
+    else
+        this->env_.assign(s);
+    return *this;
+}
+
+Option &Option::required(bool b) {
+    this->required_ = b;
+    return *this;
+}
+
 // builders (override)
 Option &Option::help(const char *s) {
     this->Param::help(s);
@@ -55,13 +92,21 @@ Option &Option::help(const char *s) {
 
 // accessors
 const char *Option::longname() const {
-    return this->longname_.data();
+    return this->longname_.empty() ? this->name() : this->longname_.data();
 }
 
 char Option::shortname() const {
     return this->shortname_;
 }
 
+const char *Option::env() const {
+    return this->env_.data();
+}
+
+bool Option::required() const {
+    return this->required_;
+}
+
 unsigned int Option::count() const {
     return this->count_;
 }
@@ -71,4 +116,18 @@ void Option::match() {
     this->count_++;
 }
 
+void Option::match(unsigned int n) {
+    this->count_ += n;
+}
+
+void Option::reset() {
+    this->count_ = 0;
+}
+
+void Option::intern(std::pmr::memory_resource *mr) {
+    this->Param::intern(mr);
+    this->longname_.intern(mr);
+    this->env_.intern(mr);
+}
+
 } // namespace clip
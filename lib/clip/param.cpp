@@ -10,26 +10,49 @@
 
 #include "clip/param.h"
 
-#include <string>
+#include <memory_resource>
+
+#include "clip/text.h"
 
 namespace clip {
 
 // class Param
 // ctors
-Param::Param(const char *name) : name(name), help_("") {}
+Param::Param(const char *name) : name_(name), help_(), borrow_(false) {}
+
+Param::Param(const char *name, Borrowed) : name_(), help_(), borrow_(true) {
+    this->name_.borrow(name);
+}
 
 // dtor
 Param::~Param() = default;
 
 // builders
 Param &Param::help(const char *s) {
-    this->help_ = std::string(s);
+    if (this->borrow_)
+        this->help_.borrow(s);
+    else
+        this->help_.assign(s);
     return *this;
 }
 
 // accessors
+const char *Param::name() const {
+    return this->name_.data();
+}
+
 const char *Param::help() const {
     return this->help_.data();
 }
 
+bool Param::borrow() const {
+    return this->borrow_;
+}
+
+// methods
+void Param::intern(std::pmr::memory_resource *mr) {
+    this->name_.intern(mr);
+    this->help_.intern(mr);
+}
+
 } // namespace clip
@@ -11,62 +11,335 @@
 #include "clip/parser.h"
 
 #include <fmt/core.h>
+#include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "clip/arg.h"
+#include "clip/config.h"
+#include "clip/constraint.h"
+#include "clip/convert.h"
+#include "clip/error.h"
 #include "clip/flag.h"
+#include "clip/handle.h"
+#include "clip/index.h"
 #include "clip/opt.h"
 #include "clip/option.h"
 #include "clip/param.h"
+#include "clip/result.h"
+#include "clip/stats.h"
+#include "clip/token.h"
+#include "clip/value.h"
 
 namespace clip {
 
+namespace {
+
+// Help layout (in columns)
+constexpr std::size_t TABWIDTH = 8;
+constexpr std::size_t MINCOLUMN = 16;
+constexpr std::size_t MAXCOLUMN = 40;
+constexpr std::size_t MINWRAP = 24;    // narrowest help text worth wrapping
+constexpr std::size_t HELPSLACK = 256; // headers and section titles
+
+// Fewest deferred values worth converting on another thread
+constexpr std::size_t GRAIN = 16 * 1024;
+
+// Every character, so that short option keys outlive the token they were read from
+constexpr auto SHORTKEYS = [] {
+    std::array<char, 256> keys{};
+    for (std::size_t c = 0; c < keys.size(); c++)
+        keys[c] = static_cast<char>(c);
+    return keys;
+}();
+
+// Completion scripts (formatted with the app's name and a shell function name)
+constexpr const char *BASH = R"sh(# bash completion for {name}
+{fn}() {{
+    local IFS=$'\n'
+    COMPREPLY=($("${{COMP_WORDS[0]}}" --clip-complete "$COMP_CWORD" "${{COMP_WORDS[@]}}" \
+        2>/dev/null))
+}}
+complete -o default -F {fn} {name}
+)sh";
+constexpr const char *ZSH = R"sh(#compdef {name}
+{fn}() {{
+    local out
+    out=$("${{words[1]}}" --clip-complete $((CURRENT - 1)) "${{words[@]}}" 2>/dev/null)
+    local -a reply=(${{(f)out}})
+    if (( ${{#reply}} )); then
+        compadd -a reply
+    else
+        _files
+    fi
+}}
+compdef {fn} {name}
+)sh";
+constexpr const char *FISH = R"sh(# fish completion for {name}
+function {fn}
+    set -l words (commandline -opc)
+    $words[1] --clip-complete (count $words) $words (commandline -ct) 2>/dev/null
+end
+complete -c {name} -a '({fn})'
+)sh";
+
+// Width of the terminal at `fd`, or 0 (unlimited) if it isn't one
+std::size_t terminalWidth(int fd) {
+    struct winsize ws;
+    if (::isatty(fd) && ::ioctl(fd, TIOCGWINSZ, &ws) == 0 && ws.ws_col)
+        return ws.ws_col;
+    if (const char *columns = std::getenv("COLUMNS"))
+        return std::strtoul(columns, nullptr, 10);
+    return 0;
+}
+
+// Append help text starting at `column`, aligned after the names starting at `start`
+//
+// Text is wrapped at spaces to fit within `width`, continuing on lines indented to `column`. Any
+// choices follow the text, wrapped between names.
+void describe(std::string &out,
+              std::size_t start,
+              std::string_view help,
+              std::size_t column,
+              std::size_t width,
+              std::span<const std::string_view> choices = {}) {
+    // Align to column (moving to the next line if names overflow it)
+    std::size_t len = out.size() - start;
+    if (len < column) {
+        out.append(column - len, ' ');
+    } else {
+        out += "\n\t";
+        out.append(column, ' ');
+    }
+
+    // Wrap help text
+    std::size_t avail = width > TABWIDTH + column ? width - TABWIDTH - column : 0;
+    while (avail >= MINWRAP && help.size() > avail) {
+        std::size_t cut = help.rfind(' ', avail);
+        if (cut == std::string_view::npos || !cut)
+            cut = help.find(' ', avail);
+        if (cut == std::string_view::npos)
+            break;
+        out.append(help.substr(0, cut));
+        out += "\n\t";
+        out.append(column, ' ');
+        std::size_t next = help.find_first_not_of(' ', cut);
+        help.remove_prefix(next != std::string_view::npos ? next : help.size());
+    }
+    out.append(help);
+
+    // List choices
+    std::size_t pos = out.size() - (out.rfind('\t') + 1); // column within the current line
+    for (std::size_t i = 0; i < choices.size(); i++) {
+        std::string_view prefix = i ? "" : "[choices: ";
+        std::size_t len = prefix.size() + choices[i].size() + 1;
+        if (avail >= MINWRAP && pos + 1 + len > column + avail) {
+            out += "\n\t";
+            out.append(column, ' ');
+            pos = column;
+        } else if (pos > column) {
+            out += ' ';
+            pos++;
+        }
+        out.append(prefix).append(choices[i]).append(1, i + 1 < choices.size() ? ',' : ']');
+        pos += len;
+    }
+    out += '\n';
+}
+
+// Tokens of an environment variable split at whitespace, followed by those of another source
+//
+// Tokens are views into the environment, which outlives the parse.
+class EnvSource final : public Source {
+private:
+    // constants
+    static constexpr std::string_view SPACE = " \t\n\v\f\r";
+
+    // impl members
+    std::string_view buffer;
+    Source &source;
+
+public:
+    // ctors
+    EnvSource(const std::string &var, Source &source) : buffer(), source(source) {
+        if (const char *s = var.empty() ? nullptr : std::getenv(var.data()))
+            this->buffer = s;
+    }
+
+    // accessors
+    virtual bool stable() const override {
+        return this->source.stable();
+    }
+
+    // methods
+    virtual bool next(std::string_view &token) override {
+        // Continue with the source once the variable is exhausted
+        std::size_t start = this->buffer.find_first_not_of(SPACE);
+        if (start == std::string_view::npos) {
+            this->buffer = {};
+            return this->source.next(token);
+        }
+        this->buffer.remove_prefix(start);
+        token = this->buffer.substr(0, this->buffer.find_first_of(SPACE));
+        this->buffer.remove_prefix(token.size());
+        return true;
+    }
+};
+
+// Count hidden arguments taken ahead of any parsing (as `--clip-trace=<path>`, which must be seen
+// before params are registered)
+int hidden(int argc, char *argv[]) {
+    constexpr std::string_view trace = "--clip-trace=";
+    if (argc < 2 || !std::string_view(argv[1]).starts_with(trace))
+        return 0;
+    CLIP_STATS_OUTPUT(argv[1] + trace.size());
+    return 1;
+}
+
+} // namespace
+
 // class Parser
 // ctors
 Parser::Parser(int argc, char *argv[], const App &app) :
-    argc(argc - 1),
-    argv(&argv[1]),
+    argc(argc - 1 - hidden(argc, argv)),
+    argv(&argv[argc - this->argc]),
     app(app),
-    autohelp(true) {}
+    arena(),
+    addednames(&this->arena),
+    addedlongnames(&this->arena),
+    bits(0),
+    footprint(0),
+    generation(0),
+    nthreads(1),
+    state(),
+    autohelp(true),
+    autoflags(false),
+    frozen(false),
+    repeated(false),
+    abbrev(false),
+    constrained(false),
+    variadic(false),
+    stats_() {
+    this->shortnames.fill(Index::npos);
+}
+
+Parser::Parser(const App &app) :
+    argc(0),
+    argv(nullptr),
+    app(app),
+    arena(),
+    addednames(&this->arena),
+    addedlongnames(&this->arena),
+    bits(0),
+    footprint(0),
+    generation(0),
+    nthreads(1),
+    state(),
+    autohelp(true),
+    autoflags(false),
+    frozen(false),
+    repeated(false),
+    abbrev(false),
+    constrained(false),
+    variadic(false),
+    stats_() {
+    this->shortnames.fill(Index::npos);
+}
 
 // builders
-Parser &Parser::add(const Flag &flag) {
-    // Insert param within parser
-    if (this->insert(static_cast<Param *>(new Flag(flag)))) {
-        // Append name to flags
-        this->flags.push_back(flag.name);
-    }
+Handle<Flag> Parser::add(const Flag &flag) {
+    // Insert param within parser, appending slot to flags
+    std::size_t idx = this->insert(flag);
+    this->flags.push_back(idx);
+    return this->handle<Flag>(idx);
+}
+
+Handle<Flag> Parser::add(Flag &&flag) {
+    // Insert param within parser, appending slot to flags
+    std::size_t idx = this->insert(std::move(flag));
+    this->flags.push_back(idx);
+    return this->handle<Flag>(idx);
+}
+
+Parser &Parser::command(const char *name, const char *help, Factory factory) {
+    // Check name can be told apart from options
+    if (!*name || *name == '-')
+        throw std::invalid_argument(fmt::format("invalid command name: `{}`", name));
+    // Append command (collisions are resolved once frozen)
+    Command &command = this->commands.emplace_back();
+    command.name = name;
+    command.help = help;
+    command.factory = std::move(factory);
+    this->frozen = false;
     return *this;
 }
 
-template <typename T>
-Parser &Parser::add(const Opt<T> &opt) {
-    // Insert param within parser
-    if (this->insert(static_cast<Param *>(new Opt<T>(opt)))) {
-        // Append name to opts
-        this->opts.push_back(opt.name);
-    }
+Parser &Parser::abbreviate(bool b) {
+    this->abbrev = b;
+    this->frozen = false; // prefixes are indexed on freeze
     return *this;
 }
 
-template <typename T>
-Parser &Parser::add(const Arg<T> &arg) {
-    // Insert param within parser
-    if (this->insert(static_cast<Param *>(new Arg<T>(arg)))) {
-        // Append name to args
-        this->args.push_back(arg.name);
-    }
-    // Update autohelp
-    if (this->autohelp && !arg.optional())
-        this->autohelp = false;
+Parser &Parser::config(const char *path) {
+    this->configs.emplace_back(path);
+    this->frozen = false; // results lay out a bitset for config files
+    return *this;
+}
+
+Parser &Parser::conflicts(const char *name, const char *other) {
+    this->relations.push_back({Constraints::Rule::Conflicts, {name, other}});
+    this->frozen = false;
+    return *this;
+}
+
+Parser &Parser::needs(const char *name, const char *other) {
+    this->relations.push_back({Constraints::Rule::Needs, {name, other}});
+    this->frozen = false;
+    return *this;
+}
+
+Parser &Parser::anyOf(std::initializer_list<const char *> names) {
+    this->relations.push_back({Constraints::Rule::AnyOf, {names.begin(), names.end()}});
+    this->frozen = false;
+    return *this;
+}
+
+Parser &Parser::oneOf(std::initializer_list<const char *> names) {
+    this->relations.push_back({Constraints::Rule::OneOf, {names.begin(), names.end()}});
+    this->frozen = false;
+    return *this;
+}
+
+Parser &Parser::parallel(std::size_t threads) {
+    this->nthreads = threads ? threads : std::max(std::thread::hardware_concurrency(), 1u);
     return *this;
 }
 
@@ -75,74 +348,274 @@ const decltype(Parser::params) &Parser::data() {
     return this->params;
 }
 
-template <typename P>
-const P &Parser::get(const char *name) const {
-    return *dynamic_cast<P *>(this->params.at(name).get());
-}
-
 const Flag &Parser::getFlag(const char *name) const {
     return this->get<Flag>(name);
 }
 
-template <typename T>
-const Opt<T> &Parser::getOpt(const char *name) const {
-    return this->get<Opt<T>>(name);
+Parser *Parser::command() const {
+    if (!this->state || this->state->command_ == Index::npos)
+        return nullptr;
+    return this->commands[this->state->command_].parser.get();
 }
 
-template <typename T>
-const Arg<T> &Parser::getArg(const char *name) const {
-    return this->get<Arg<T>>(name);
+Stats Parser::stats() const {
+    // Load each field atomically (as results may be parsed into concurrently)
+    static constexpr std::uint64_t Stats::*fields[] = {
+        &Stats::add,
+        &Stats::freeze,
+        &Stats::parse,
+        &Stats::tokenize,
+        &Stats::lookup,
+        &Stats::convert,
+        &Stats::autoflags,
+        &Stats::help,
+        &Stats::params,
+        &Stats::tokens,
+        &Stats::lookups,
+        &Stats::conversions,
+        &Stats::strings,
+        &Stats::bytes,
+    };
+    static_assert(sizeof(fields) / sizeof(*fields) * sizeof(std::uint64_t) == sizeof(Stats));
+    Stats stats{};
+    for (auto field : fields)
+        stats.*field = std::atomic_ref(this->stats_.*field).load(std::memory_order_relaxed);
+    return stats;
 }
 
 // methods
-void Parser::parse() {
-    // Add automatic flags
-    this->addAutoflags();
+void Parser::freeze() {
+    // Check if already frozen
+    if (this->frozen)
+        return;
+    CLIP_STATS_SCOPE(this->stats_);
+    CLIP_STATS_SPAN(freeze);
 
-    // Skip options after finding "--" terminator
-    bool doneopts = false;
-    // Keep track of the next positional arg
-    std::size_t argidx = 0;
+    // Restore params from any earlier parse (indices are about to change)
+    this->reset();
+    this->state = nullptr;
 
-    // Show help if no arguments supplied
-    if (!this->argc && this->autohelp) {
-        std::cout << this->help_s();
-        std::exit(1);
+    // Add automatic flags (once)
+    if (!this->autoflags) {
+        this->autoflags = true;
+        this->addAutoflags();
     }
 
-    // Parse each argument
-    for (int i = 0; i < this->argc; i++) {
-        // Extract this argument
-        std::string arg(this->argv[i]);
+    // Sort longnames for prefix queries
+    const std::size_t n = this->params.size();
+    std::vector<std::pair<std::string_view, std::size_t>> keys;
+    this->sortedlongnames.clear();
+    for (std::size_t i = 0; i < n; i++)
+        if (Option *option = this->slots[i].option; option && *option->longname())
+            this->sortedlongnames.emplace_back(option->longname(), i);
+    std::sort(this->sortedlongnames.begin(), this->sortedlongnames.end());
+    this->bound.clear();
+    for (std::size_t i = 0; i < n; i++)
+        if (this->slots[i].store)
+            this->bound.push_back(i);
 
-        // clang-format off
-        // Match option terminator
-        if (!doneopts && arg == "--")
-            doneopts = true;
-        // Match long options
-        else if ((!doneopts && arg.starts_with("--")) &&
-                 this->parseLongOption(i))
-            ;
-        // Match short options
-        else if ((!doneopts && arg.starts_with("-")) &&
-                 this->parseShortOption(i))
-            ;
-        // Match positional arguments
-        else if ((argidx < this->args.size()) &&
-                this->parseArg(i, argidx))
-            ;
-        // Handle extra values
+    // Index names, longnames and shortnames
+    this->names.clear();
+    this->longnames.clear();
+    this->shortnames.fill(Index::npos);
+    for (std::size_t i = 0; i < n; i++) {
+        this->names.insert(this->params[i]->name(), i);
+        Option *option = this->slots[i].option;
+        if (!option)
+            continue;
+        if (*option->longname())
+            this->longnames.insert(option->longname(), i);
+        // Map shortname (first registration wins)
+        auto c = static_cast<unsigned char>(option->shortname());
+        if (c && this->shortnames[c] == Index::npos)
+            this->shortnames[c] = i;
+    }
+    this->names.build();
+    this->longnames.build();
+
+    // Index each prefix of the sorted longnames at the first sharing it (its candidates follow)
+    this->prefixes.clear();
+    if (this->abbrev) {
+        const Sorted &sorted = this->sortedlongnames;
+        for (std::size_t i = 0; i < sorted.size(); i++) {
+            std::string_view key = sorted[i].first;
+            std::size_t shared = 0;
+            if (i > 0) {
+                std::string_view prev = sorted[i - 1].first;
+                auto diff = std::mismatch(key.begin(), key.end(), prev.begin(), prev.end());
+                shared = diff.first - key.begin();
+            }
+            for (std::size_t len = shared + 1; len <= key.size(); len++)
+                this->prefixes.insert(key.substr(0, len), i);
+        }
+    }
+    this->prefixes.build();
+
+    // Index environment variables (explicit names win over derived ones)
+    keys.clear();
+    for (std::size_t i = 0; i < n; i++)
+        if (Option *option = this->slots[i].option; option && *option->env())
+            keys.emplace_back(option->env(), i);
+    if (const std::string &prefix = this->app.env(); !prefix.empty()) {
+        std::pmr::polymorphic_allocator<char> alloc(&this->arena);
+        for (std::size_t i = 0; i < n; i++) {
+            // Derive from prefix and longname (e.g. `APP_` and `dry-run` make `APP_DRY_RUN`)
+            Option *option = this->slots[i].option;
+            if (!option || *option->env() || !*option->longname())
+                continue;
+            if (std::string_view name = option->name(); name == "help" || name == "version")
+                continue;
+            std::string_view longname = option->longname();
+            char *s = alloc.allocate(prefix.size() + longname.size());
+            char *end = std::copy(prefix.begin(), prefix.end(), s);
+            end = std::transform(longname.begin(), longname.end(), end, [](unsigned char c) {
+                return c == '-' ? '_' : static_cast<char>(std::toupper(c));
+            });
+            keys.emplace_back(std::string_view(s, end - s), i);
+        }
+    }
+    std::stable_sort(keys.begin(), keys.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+    this->envnames.clear();
+    for (std::size_t i = 0; i < keys.size(); i++)
+        if (!i || keys[i].first != keys[i - 1].first)
+            this->envnames.insert(keys[i].first, keys[i].second);
+    this->envnames.build();
+
+    // Index commands (first registration wins)
+    keys.clear();
+    for (std::size_t i = 0; i < this->commands.size(); i++)
+        keys.emplace_back(this->commands[i].name, i);
+    std::sort(keys.begin(), keys.end());
+    this->commandnames.clear();
+    this->sortedcommands.clear();
+    for (std::size_t i = 0; i < keys.size(); i++)
+        if (!i || keys[i].first != keys[i - 1].first) {
+            this->commandnames.insert(keys[i].first, keys[i].second);
+            this->sortedcommands.push_back(keys[i]);
+        }
+    this->commandnames.build();
+
+    // Check for repeated opts, and a repeated last arg (which takes any remaining positionals)
+    this->repeated = std::any_of(this->opts.begin(), this->opts.end(), [&](std::size_t idx) {
+        return this->slots[idx].value->repeated();
+    });
+    this->variadic = !this->args.empty() && this->slots[this->args.back()].value->repeated();
+
+    // Compile constraints into masks over slots
+    this->constraints.clear(n);
+    for (std::size_t i = 0; i < n; i++) {
+        const Slot &slot = this->slots[i];
+        if (slot.option && slot.option->required())
+            this->constraints.require(i);
+        if (slot.ranged)
+            this->constraints.range(i);
+    }
+    std::vector<std::size_t> members;
+    for (const Relation &relation : this->relations) {
+        members.clear();
+        for (const std::string &name : relation.names) {
+            std::size_t idx = this->names.find(name);
+            if (idx == Index::npos)
+                throw std::invalid_argument(fmt::format("unknown param in constraint: `{}`", name));
+            members.push_back(idx);
+        }
+        if (relation.rule == Constraints::Rule::Conflicts)
+            this->constraints.conflict(members[0], members[1]);
+        else if (relation.rule == Constraints::Rule::Needs)
+            this->constraints.need(members[0], members[1]);
         else
-            Parser::error(1, fmt::format("unexpected token: `{}`", this->argv[i]));
-        // clang-format on
+            this->constraints.group(relation.rule, members);
+    }
+    this->constraints.build();
+    this->constrained = !this->constraints.empty();
+
+    // Lay out results (and reallocate our own)
+    this->layout();
+    this->frozen = true;
+    this->state = std::make_unique<Result>(*this);
+}
+
+void Parser::parse() {
+    // Parse argv, exiting on failure
+    if (auto result = this->tryParse(); !result)
+        this->exit(result.error());
+}
+
+void Parser::parse(Source &source) {
+    // Parse source, exiting on failure
+    if (auto result = this->tryParse(source); !result)
+        this->exit(result.error());
+}
+
+Expected<void> Parser::tryParse() {
+    // Freeze parser
+    this->freeze();
+
+    // Answer shell completion (before any parsing)
+    if (this->argc) {
+        std::string_view mode = this->argv[0];
+        if (mode == "--clip-complete" || mode == "--clip-complete-script")
+            return this->parseComplete();
     }
+    this->reset();
+
+    // Size repeated values up front (argv can be scanned twice)
+    if (this->repeated)
+        this->reserveRepeated(*this->state);
 
-    // Handle missing arguments
-    if (argidx < this->args.size())
-        Parser::error(1, "missing arguments");
+    // Parse argv (after any arguments from the environment)
+    ArgvSource argv(this->argc, this->argv);
+    EnvSource source(this->app.envargs(), argv);
+    Expected<void> result = this->parseTokens(source, *this->state, true);
+    this->publish(*this->state);
+    return result;
+}
+
+Expected<void> Parser::tryParse(Source &source) {
+    // Freeze parser
+    this->freeze();
+    this->reset();
+
+    // Parse source (after any arguments from the environment)
+    EnvSource env(this->app.envargs(), source);
+    Expected<void> result = this->parseTokens(env, *this->state, true);
+    this->publish(*this->state);
+    return result;
+}
+
+Expected<void> Parser::tryParse(Source &source, Result &result) const {
+    // Check result belongs to this (frozen) parser
+    if (!this->frozen)
+        throw std::logic_error("parser must be frozen");
+    if (result.parser != this)
+        throw std::invalid_argument("result belongs to another parser");
+    result.check();
+
+    // Parse source
+    result.reset();
+    return this->parseTokens(source, result, false);
+}
+
+void Parser::reset() {
+    // Check for an earlier parse
+    if (!this->state)
+        return;
+
+    // Restore params touched by the last parse
+    for (std::size_t idx : this->state->touched) {
+        const Slot &slot = this->slots[idx];
+        if (slot.option)
+            slot.option->reset();
+        if (slot.value)
+            slot.value->reset();
+    }
+    if (Parser *command = this->command())
+        command->reset();
+    this->state->reset();
 }
 
-// static methods
 void Parser::error(unsigned char ret, const std::string &msg) {
     const bool colourize = ::isatty(::fileno(stderr));
     // clang-format off
@@ -155,333 +628,1044 @@ void Parser::error(unsigned char ret, const std::string &msg) {
     std::exit(ret);
 }
 
-// mutators
-bool Parser::insert(Param *param) {
-    // Set up options
-    Option *option = dynamic_cast<Option *>(param);
-    if (option) {
-        // Ensure no name collisions
-        if ((option->longname() && this->longnames.contains(option->longname())) ||
-            (!option->shortname() && this->shortnames.contains(option->shortname())))
-            return false;
-
-        // Map longname to name
-        if (option->longname())
-            this->longnames.insert(std::make_pair(option->longname(), option->name));
-        // Map shortname to name
-        if (option->shortname())
-            this->shortnames.insert(std::make_pair(option->shortname(), option->name));
-    }
+// types
+void Parser::Destroy::operator()(Param *param) const {
+    // Storage is reclaimed with the arena
+    param->~Param();
+}
 
-    // Map name to param
-    if (!this->params.insert(std::make_pair(param->name, param)).second)
-        return false; // name collision
+// accessors
+const void *Parser::find(const char *name, const void *type) const {
+    // Search for a match
+    std::size_t slot = Index::npos;
+    if (this->frozen)
+        slot = this->names.find(name);
+    else
+        for (std::size_t i = 0; i < this->params.size() && slot == Index::npos; i++)
+            if (std::string_view(this->params[i]->name()) == name)
+                slot = i;
+    if (slot == Index::npos)
+        throw std::out_of_range(fmt::format("unknown param: `{}`", name));
 
-    return true; // insertion successful
+    // Check requested type
+    if (!type)
+        return this->params[slot].get();
+    if (this->slots[slot].type != type)
+        throw std::invalid_argument(fmt::format("type mismatch for param: `{}`", name));
+    return this->slots[slot].object;
 }
 
 // helpers
 void Parser::addAutoflags() {
-    // Add automatic flags
-    this->add(Flag("help").shortname('h').help("Print this message."));
-    if (app.version().length())
+    // Add automatic flags (unless taken by the caller's params)
+    auto free = [this](std::string_view name) {
+        return !this->addednames.contains(name) && !this->addedlongnames.contains(name);
+    };
+    if (free("help"))
+        this->add(Flag("help").shortname('h').help("Print this message."));
+    if (app.version().length() && free("version"))
         this->add(Flag("version").shortname('V').help("Print version information."));
 }
 
-void Parser::checkAutoflags(Option *option) const {
+void Parser::checkUnique(const char *name, const char *longname) const {
+    // Reject names and longnames taken by an earlier param
+    if (this->addednames.contains(name))
+        throw std::invalid_argument(fmt::format("duplicate param name: `{}`", name));
+    if (*longname && this->addedlongnames.contains(longname))
+        throw std::invalid_argument(fmt::format("duplicate longname: `--{}`", longname));
+}
+
+void Parser::layout() {
+    // Place counts first, then the bitset of matched slots (when constrained or layered with
+    // config files), followed by each value at its natural alignment
+    using Word = Constraints::Word;
+    std::size_t offset = this->slots.size() * sizeof(std::uint32_t);
+    offset = (offset + alignof(Word) - 1) / alignof(Word) * alignof(Word);
+    this->bits = offset;
+    if (this->constrained || !this->configs.empty())
+        offset += this->constraints.words() * sizeof(Word);
+    for (Slot &slot : this->slots) {
+        if (!slot.ops)
+            continue;
+        offset = (offset + slot.ops->align - 1) / slot.ops->align * slot.ops->align;
+        slot.offset = offset;
+        offset += slot.ops->size;
+    }
+    // Round up to whole cache lines
+    this->footprint = (offset + Result::ALIGN - 1) / Result::ALIGN * Result::ALIGN;
+    // Invalidate results laid out before
+    this->generation++;
+}
+
+Parser &Parser::build(std::size_t idx) const {
+    // Build subcommand on first use (once, even when shared between threads)
+    Command &command = this->commands[idx];
+    std::call_once(command.built, [&] {
+        std::string name = fmt::format("{} {}", this->app.name, command.name);
+        auto parser = std::make_unique<Parser>(App(name.data())
+                                                   .about(command.help.data())
+                                                   .version(this->app.version().data())
+                                                   .env(this->app.env().data()));
+        parser->abbreviate(this->abbrev);
+        command.factory(*parser);
+        parser->autohelp = false; // selecting a subcommand is an argument in itself
+        parser->freeze();
+        command.parser = std::move(parser);
+    });
+    return *command.parser;
+}
+
+void Parser::publish(Result &result) {
+    // Exchange touched counts and values into params
+    const std::uint32_t *counts = result.counts();
+    for (std::size_t idx : result.touched) {
+        const Slot &slot = this->slots[idx];
+        if (slot.option)
+            slot.option->match(counts[idx]);
+        if (slot.ops)
+            slot.ops->publish(slot.object, result.at(idx));
+    }
+    // Store every bound param (defaults included) into its target
+    for (std::size_t idx : this->bound)
+        this->slots[idx].store(this->slots[idx].object);
+
+    // Adopt the subcommand's result as its own, then publish it in turn
+    if (result.command_ != Index::npos) {
+        Parser &command = *this->commands[result.command_].parser;
+        command.reset();
+        std::swap(command.state, result.sub);
+        command.publish(*command.state);
+    }
+}
+
+void Parser::exit(const Error &error) const {
+    // Find selected subcommand
+    const Parser *parser = this;
+    while (const Parser *command = parser->command())
+        parser = command;
+
+    // Print requested output, or report error
+    switch (error.code) {
+        case Errc::Help:
+        case Errc::Usage: std::cout.flush(), parser->printHelp(STDOUT_FILENO); break;
+        case Errc::Version: std::cout << parser->version_s() << std::endl; break;
+        case Errc::Complete: std::cout << error.message << std::flush; break;
+        default: Parser::error(error.status(), error.message);
+    }
+    std::exit(error.status());
+}
+
+Expected<void> Parser::parseTokens(Source &source, Result &result, bool layers) const {
+    // Parse each argument as it arrives, expanding response files
+    Tokens tokens(source);
+    return this->parseTokens(tokens, result, layers);
+}
+
+Expected<void> Parser::parseTokens(Tokens &tokens, Result &result, bool layers) const {
+    CLIP_STATS_SCOPE(this->stats_);
+    CLIP_STATS_SPAN(parse);
+    // Skip options after finding "--" terminator
+    bool doneopts = false;
+    // Keep track of the next positional arg
+    std::size_t argidx = 0;
+    // Keep track of whether any arguments were supplied
+    bool empty = true;
+    // Keep track of whether a subcommand took the remaining arguments
+    bool selected = false;
+
+    // Defer conversions of repeated values when parallel
+    result.deferring = this->nthreads > 1 && tokens.stable();
+    if (result.deferring && result.pending.size() != this->slots.size())
+        result.pending.assign(this->slots.size(), 0);
+    std::string_view arg;
+    while (!selected && tokens.next(arg)) {
+        empty = false;
+
+        // clang-format off
+        Expected<void> status;
+        // Match option terminator
+        if (!doneopts && arg == "--") {
+            doneopts = true;
+            tokens.verbatim(); // response files too are taken literally
+        }
+        // Match long options
+        else if (!doneopts && arg.starts_with("--"))
+            status = this->parseLongOption(tokens, result, arg);
+        // Match short options
+        else if (!doneopts && arg.size() > 1 && arg.starts_with("-"))
+            status = this->parseShortOption(tokens, result, arg);
+        // Match subcommands (in place of the first positional argument)
+        else if (!doneopts && argidx == 0 && !this->commands.empty() &&
+                 (this->commandnames.find(arg) != Index::npos || this->args.empty())) {
+            std::size_t idx = this->commandnames.find(arg);
+            if (idx == Index::npos)
+                return Error{Errc::Unknown, fmt::format("unknown command: `{}`", arg)};
+            // Convert deferred values first (the subcommand parses into its own result)
+            status = this->parseDeferred(result);
+            if (status)
+                status = this->parseCommand(tokens, result, idx, layers);
+            selected = true;
+        }
+        // Match positional arguments
+        else if (argidx < this->args.size() || this->variadic)
+            status = this->parseArg(result, arg, argidx);
+        // Handle extra values
+        else
+            status = Error{Errc::Unexpected, fmt::format("unexpected token: `{}`", arg)};
+        // clang-format on
+
+        // Stop at the first error (preferring invalid values deferred before it, then errors
+        // from response files)
+        if (!status) {
+            if (auto deferred = this->parseDeferred(result); !deferred)
+                return deferred;
+            return tokens.error() ? *tokens.error() : status;
+        }
+    }
+    // Convert deferred values (reporting the first invalid one)
+    if (auto status = this->parseDeferred(result); !status)
+        return status;
+    if (tokens.error())
+        return *tokens.error();
+
+    // Fall back to the environment and config files for unmatched options
+    if (layers)
+        if (auto status = this->parseLayers(result); !status)
+            return status;
+
+    // Show help if no arguments supplied (nor any from other layers)
+    if (empty && this->autohelp && result.touched.empty())
+        return Error{Errc::Usage, "no arguments supplied"};
+
+    // Handle missing arguments (unless taken by a subcommand)
+    if (!selected && argidx < this->args.size())
+        return Error{Errc::Missing, "missing arguments"};
+    if (!selected && !this->commands.empty() && this->args.empty())
+        return Error{Errc::Missing, "missing command"};
+
+    // Finish repeated values
+    if (this->repeated)
+        for (std::size_t idx : result.touched)
+            if (const Ops *ops = this->slots[idx].ops)
+                ops->finish(result.at(idx));
+
+    // Check constraints in a single pass over matched slots
+    if (this->constrained)
+        return this->checkConstraints(result);
+
+    return {};
+}
+
+Expected<void> Parser::parseLayers(Result &result) const {
+    // Apply layers in decreasing precedence, each filling only what remains unmatched
+    if (auto status = this->parseEnv(result); !status)
+        return status;
+    for (auto it = this->configs.rbegin(); it != this->configs.rend(); ++it)
+        if (auto status = this->parseConfig(result, it->data()); !status)
+            return status;
+    return {};
+}
+
+Expected<void> Parser::parseEnv(Result &result) const {
+    // Check for bound variables
+    if (!this->envnames.size())
+        return {};
+
+    // Match each variable in a single pass over the environment
+    for (char **var = environ; *var; var++) {
+        std::string_view entry(*var);
+        std::size_t eq = entry.find('=');
+        if (eq == std::string_view::npos)
+            continue;
+        std::string_view key = entry.substr(0, eq);
+        std::string_view value = entry.substr(eq + 1);
+        CLIP_STATS_COUNT(lookups, 1);
+        std::size_t idx = this->envnames.find(key);
+        // Skip options matched on the command line (which take precedence)
+        if (idx == Index::npos || result.counts()[idx])
+            continue;
+
+        // Dispatch on kind of match
+        const Slot &match = this->slots[idx];
+        if (match.kind == Kind::Flag && (value.empty() || value == "0" || value == "false"))
+            continue; // flag is unset
+        this->match(result, idx);
+        if (match.kind != Kind::Flag && !match.ops->parse(result.at(idx), value))
+            return Error{Errc::Invalid, fmt::format("invalid value for `${}={}`", key, value)};
+    }
+
+    return {};
+}
+
+Expected<void> Parser::parseConfig(Result &result, const char *path) const {
+    // Map file (skipping missing files)
+    std::optional<ConfigFile> file;
+    try {
+        file.emplace(path);
+    } catch (const std::system_error &e) {
+        if (e.code() == std::errc::no_such_file_or_directory)
+            return {};
+        return Error{Errc::Config, e.what()};
+    }
+
+    // Match each entry's key against longnames
+    const Constraints::Word *matched = this->mark(result); // by higher layers
+    ConfigFile::Entry entry;
+    while (file->next(entry)) {
+        CLIP_STATS_COUNT(lookups, 1);
+        std::size_t idx = this->longnames.find(entry.key);
+        if (idx == Index::npos || entry.key == "help" || entry.key == "version")
+            return file->fail(Errc::Unknown, fmt::format("unknown key: `{}`", entry.key));
+        // Skip options matched by a higher layer (but not earlier lines of this file)
+        if (matched[idx / Constraints::BITS] >> (idx % Constraints::BITS) & 1)
+            continue;
+
+        const Slot &match = this->slots[idx];
+        bool valid;
+        if (match.kind != Kind::Flag) {
+            // Count this match, then parse value into result
+            this->match(result, idx);
+            valid = match.ops->parse(result.at(idx), entry.value);
+        } else {
+            // Count flags by a boolean or a count
+            unsigned n = entry.value == "true";
+            valid = n || entry.value == "false" || convert(entry.value, n);
+            if (valid && n) {
+                this->match(result, idx);
+                result.counts()[idx] += n - 1;
+            }
+        }
+        if (!valid)
+            return file->fail(Errc::Invalid,
+                              fmt::format("invalid value for `{} = {}`", entry.key, entry.value));
+    }
+    if (file->error())
+        return *file->error();
+
+    return {};
+}
+
+Expected<void> Parser::checkAutoflags(Option *option) const {
+    CLIP_STATS_TIME(autoflags);
     // Check for automatic flags
-    if (option->name == "help") {
-        std::cout << this->help_s();
-        std::exit(0);
-    } else if (option->name == "version") {
-        std::cout << this->version_s() << std::endl;
-        std::exit(0);
+    std::string_view name = option->name();
+    if (name == "help")
+        return Error{Errc::Help, "help requested"};
+    else if (name == "version")
+        return Error{Errc::Version, "version requested"};
+    return {};
+}
+
+Expected<void> Parser::checkConstraints(Result &result) const {
+    using Word = Constraints::Word;
+    const Word *matched = this->mark(result);
+
+    // Name params as spelled on the command line
+    auto label = [&](std::size_t idx) {
+        const Option *option = this->slots[idx].option;
+        return option ? fmt::format("`--{}`", option->longname())
+                      : fmt::format("`{}`", this->params[idx]->name());
+    };
+    auto labels = [&](std::size_t group) {
+        std::string out;
+        for (std::size_t idx : this->constraints.group(group))
+            out += (out.empty() ? "" : ", ") + label(idx);
+        return out;
+    };
+
+    // Check matched values against their ranges
+    std::span<const Word> ranges = this->constraints.ranges();
+    for (std::size_t w = 0; w < ranges.size(); w++) {
+        for (Word bits = ranges[w] & matched[w]; bits; bits &= bits - 1) {
+            std::size_t idx = w * Constraints::BITS + std::countr_zero(bits);
+            const Slot &slot = this->slots[idx];
+            if (!slot.ops->check(slot.object, result.at(idx)))
+                return Error{Errc::Invalid, fmt::format("value out of range for {}", label(idx))};
+        }
+    }
+
+    // Check rules between params
+    using Rule = Constraints::Rule;
+    auto [rule, idx, other] = this->constraints.check(matched);
+    switch (rule) {
+        case Rule::None: return {};
+        case Rule::Required:
+            return Error{Errc::Missing, fmt::format("missing required option: {}", label(idx))};
+        case Rule::Conflicts:
+            return Error{Errc::Conflict,
+                         fmt::format("{} cannot be used with {}", label(idx), label(other))};
+        case Rule::Needs:
+            return Error{Errc::Missing, fmt::format("{} requires {}", label(idx), label(other))};
+        case Rule::AnyOf:
+            return Error{Errc::Missing, fmt::format("one of {} is required", labels(idx))};
+        case Rule::OneOf:
+            return Error{other ? Errc::Conflict : Errc::Missing,
+                         fmt::format("exactly one of {} is required", labels(idx))};
+    }
+    return {};
+}
+
+Constraints::Word *Parser::mark(Result &result) const {
+    // Collect matched slots into the result's bitset
+    using Word = Constraints::Word;
+    Word *matched = reinterpret_cast<Word *>(result.storage + this->bits);
+    std::fill_n(matched, this->constraints.words(), 0);
+    for (std::size_t idx : result.touched)
+        matched[idx / Constraints::BITS] |= Word(1) << (idx % Constraints::BITS);
+    return matched;
+}
+
+Expected<std::size_t> Parser::resolve(std::string_view longkey) const {
+    CLIP_STATS_TIME(lookup);
+    CLIP_STATS_COUNT(lookups, 1);
+    // Search for an exact match
+    if (std::size_t idx = this->longnames.find(longkey); idx != Index::npos)
+        return idx;
+
+    // Search for a unique abbreviation (adjacent to its completions once sorted)
+    if (std::size_t pos = this->prefixes.find(longkey); pos != Index::npos) {
+        const Sorted &sorted = this->sortedlongnames;
+        auto first = sorted.begin() + pos;
+        auto prefixed = [&](auto it) {
+            return it != sorted.end() && it->first.starts_with(longkey);
+        };
+        if (!prefixed(first + 1))
+            return first->second;
+        std::string candidates;
+        for (auto it = first; prefixed(it); ++it)
+            candidates.append(it == first ? "" : ", ").append("`--").append(it->first) += '`';
+        return Error{Errc::Unknown,
+                     fmt::format("ambiguous option: `--{}` (could be {})", longkey, candidates)};
+    }
+
+    return Error{Errc::Unknown, fmt::format("illegal option: `--{}`", longkey)};
+}
+
+void Parser::match(Result &result, std::size_t idx) const {
+    // Count match, recording the first since reset
+    if (result.counts()[idx]++)
+        return;
+    result.touched.push_back(idx);
+    // Replace any default of repeated values (whichever layer matches first)
+    if (const Ops *ops = this->slots[idx].ops; ops && ops->clear)
+        ops->clear(result.at(idx));
+}
+
+bool Parser::parseValue(Result &result,
+                        std::size_t idx,
+                        std::string_view value,
+                        std::string_view key,
+                        unsigned char dash) const {
+    // Parse immediately unless deferrable (optional values must be tried in place)
+    const Slot &slot = this->slots[idx];
+    if (!result.deferring || !slot.ops->convert || slot.value->optional())
+        return slot.ops->parse(result.at(idx), value);
+
+    // Defer value, noting its position among those of its slot
+    auto pos = result.pending[idx]++;
+    result.deferred.push_back({value, key, static_cast<std::uint32_t>(idx), pos, dash});
+    return true;
+}
+
+Expected<void> Parser::parseDeferred(Result &result) const {
+    // Check for deferred values
+    const std::size_t n = result.deferred.size();
+    if (!n)
+        return {};
+    CLIP_STATS_TIME(convert);
+    CLIP_STATS_COUNT(conversions, n);
+
+    // Extend each value by its deferred elements, replacing counts with the first index
+    for (std::size_t idx : result.touched) {
+        if (std::uint32_t &pending = result.pending[idx]) {
+            std::size_t first = this->slots[idx].ops->extend(result.at(idx), pending);
+            pending = static_cast<std::uint32_t>(first);
+        }
     }
+
+    // Convert elements in contiguous chunks, one per thread, noting the first invalid value
+    std::atomic<std::size_t> invalid = n;
+    auto convert = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const Result::Deferred &deferred = result.deferred[i];
+            const Slot &slot = this->slots[deferred.idx];
+            void *value = result.at(deferred.idx);
+            if (!slot.ops->convert(value, result.pending[deferred.idx] + deferred.pos,
+                                   deferred.value)) {
+                std::size_t first = invalid.load(std::memory_order_relaxed);
+                while (i < first && !invalid.compare_exchange_weak(first, i)) {}
+                return;
+            }
+        }
+    };
+    std::size_t chunks = std::min(this->nthreads, (n + GRAIN - 1) / GRAIN);
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+    for (std::size_t t = 1; t < chunks; t++)
+        threads.emplace_back(convert, n * t / chunks, n * (t + 1) / chunks);
+    convert(0, n / chunks);
+    for (std::thread &thread : threads)
+        thread.join();
+
+    // Clear deferred values
+    for (std::size_t idx : result.touched)
+        result.pending[idx] = 0;
+    std::size_t i = invalid;
+    Result::Deferred deferred = i < n ? result.deferred[i] : Result::Deferred{};
+    result.deferred.clear();
+
+    // Report the first invalid value, as if converted in place
+    if (i == n)
+        return {};
+    if (!deferred.dash)
+        return Error{Errc::Invalid,
+                     fmt::format("invalid value for `{}`", this->params[deferred.idx]->name())};
+    return Error{Errc::Invalid,
+                 fmt::format("invalid value for `{}{}={}`",
+                             std::string_view("--", deferred.dash),
+                             deferred.key,
+                             deferred.value)};
 }
 
-bool Parser::parseLongOption(int &i) {
+Expected<void> Parser::parseLongOption(Tokens &tokens,
+                                       Result &result,
+                                       std::string_view arg) const {
     // Extract from argument
-    std::string arg(this->argv[i]);
-    std::string s = arg.substr(2);
-    if (s.empty())
-        return false;
-    std::string longkey = s.substr(0, s.find("="));
-    std::string value = (s.find('=') != std::string::npos) ? s.substr(s.find("=") + 1) :
-                                                             std::string();
+    std::string_view s = arg.substr(2);
+    std::size_t eq = s.find('=');
+    std::string_view longkey = s.substr(0, eq);
+    std::string_view value = (eq != std::string_view::npos) ? s.substr(eq + 1) : std::string_view();
     // Search for a match
-    bool matched = this->longnames.contains(longkey);
-    if (!matched)
-        Parser::error(1, fmt::format("illegal option: `--{}`", longkey));
+    auto resolved = this->resolve(longkey);
+    if (!resolved)
+        return resolved.error();
+    std::size_t idx = resolved.value();
 
     // Extract match
-    std::string key = this->longnames.at(longkey);
-    Param *match = this->params.at(key).get();
-
-    // Should always be an `Option`
-    Option *option = dynamic_cast<Option *>(match);
-    if (!option)
-        Parser::error(2, fmt::format("internal error: `{}` is not an `Option", key));
+    const Slot &match = this->slots[idx];
 
     // Count this match
-    option->match();
+    this->match(result, idx);
     // Check for automatic flags
-    this->checkAutoflags(option);
+    if (auto status = this->checkAutoflags(match.option); !status)
+        return status;
 
-    // Keep track of if we've moved onto the next string
-    bool advanced = false;
+    // Dispatch on kind of match
+    switch (match.kind) {
+        case Kind::Flag: break;
+        case Kind::Opt: {
+            // Keep track of if we've moved onto the next string
+            bool advanced = false;
 
-    // Check if match is an `AbstractOpt`
-    AbstractOpt *opt = dynamic_cast<AbstractOpt *>(match);
-    if (opt) {
-        // Either use match's parsed value, or the next string
-        if (value.empty()) {
-            i++; // advance to next string
-            advanced = true;
-            if (i < this->argc)
-                value = this->argv[i];
-            else if (opt->optional())
-                return true; // we don't need a value
-            else
-                Parser::error(1, fmt::format("missing value for `--{}`", longkey));
-        }
+            // Either use match's parsed value, or the next string
+            if (value.empty()) {
+                advanced = true; // advance to next string
+                if (!tokens.next(value)) {
+                    if (match.value->optional())
+                        return {}; // we don't need a value
+                    return Error{Errc::Missing, fmt::format("missing value for `--{}`", longkey)};
+                }
+            }
 
-        // Parse value into `Value`
-        if (!opt->parse(value.data())) {
-            if (advanced && opt->optional())
-                i--; // return to previous string
-            else
-                Parser::error(1, fmt::format("invalid value for `--{}={}`", longkey, value));
+            // Parse value into result
+            if (!this->parseValue(result, idx, value, longkey, 2)) {
+                if (advanced && match.value->optional())
+                    tokens.unget(); // return to previous string
+                else
+                    return Error{Errc::Invalid,
+                                 fmt::format("invalid value for `--{}={}`", longkey, value)};
+            }
+            // Parse any remaining values
+            if (match.nargs > 1)
+                return this->parseNargs(tokens, result, idx, "--", match.option->longname());
+            break;
         }
+        case Kind::Arg:
+            return Error{Errc::Internal,
+                         fmt::format("internal error: `--{}` is not an `Option`", longkey)};
     }
 
-    return true;
+    return {};
 }
 
-bool Parser::parseShortOption(int &i) {
+Expected<void> Parser::parseShortOption(Tokens &tokens,
+                                        Result &result,
+                                        std::string_view arg) const {
     // Extract from argument
-    std::string arg(this->argv[i]);
-    std::string s = arg.substr(1);
-    if (s.empty())
-        return false;
+    std::string_view s = arg.substr(1);
 
     // Look through each character
-    for (char &shortkey : s) {
+    for (std::size_t j = 0; j < s.size(); j++) {
+        char shortkey = s[j];
         // Search for a match
-        bool matched = this->shortnames.contains(shortkey);
-        if (!matched)
-            Parser::error(1, fmt::format("illegal option: `-{}`", shortkey));
+        CLIP_STATS_COUNT(lookups, 1);
+        std::size_t idx = this->shortnames[static_cast<unsigned char>(shortkey)];
+        if (idx == Index::npos)
+            return Error{Errc::Unknown, fmt::format("illegal option: `-{}`", shortkey)};
 
-        // Extract match (will always be an `Option`)
-        std::string key = this->shortnames.at(shortkey);
-        Param *match = this->params.at(key).get();
-
-        // Should always be an `Option`
-        Option *option = dynamic_cast<Option *>(match);
-        if (!option)
-            Parser::error(2, fmt::format("internal error: `{}` is not an `Option", key));
+        // Extract match
+        const Slot &match = this->slots[idx];
 
         // Count this match
-        option->match();
+        this->match(result, idx);
         // Check for automatic flags
-        this->checkAutoflags(option);
+        if (auto status = this->checkAutoflags(match.option); !status)
+            return status;
+
+        // Dispatch on kind of match
+        switch (match.kind) {
+            case Kind::Flag: continue;
+            case Kind::Opt: break;
+            case Kind::Arg:
+                return Error{Errc::Internal,
+                             fmt::format("internal error: `-{}` is not an `Option`", shortkey)};
+        }
 
         // Keep track of if we've moved onto the next string
         bool advanced = false;
 
-        // Check if match is an `AbstractOpt`
-        AbstractOpt *opt = dynamic_cast<AbstractOpt *>(match);
-        if (opt) {
-            // Extract value from argument
-            std::string value = &(&shortkey)[1];
+        // Extract value from argument
+        std::string_view value = s.substr(j + 1);
 
-            // Either use match's parsed value, or the next string
-            if (value.empty()) {
-                i++; // advance to next string
-                advanced = true;
-                if (i < this->argc)
-                    value = this->argv[i];
-                else if (opt->optional())
-                    return true; // we don't need a value
-                else
-                    Parser::error(1, fmt::format("missing value for `-{}`", shortkey));
+        // Either use match's parsed value, or the next string
+        if (value.empty()) {
+            advanced = true; // advance to next string
+            if (!tokens.next(value)) {
+                if (match.value->optional())
+                    return {}; // we don't need a value
+                return Error{Errc::Missing, fmt::format("missing value for `-{}`", shortkey)};
             }
+        }
 
-            // Skip '=' in parsed value if present
-            else if (value[0] == '=')
-                value = value.substr(1);
+        // Skip '=' in parsed value if present
+        else if (value[0] == '=')
+            value.remove_prefix(1);
 
-            // Parse value into `Value`
-            if (!opt->parse(value.data())) {
-                if (advanced && opt->optional())
-                    i--; // return to previous string
-                else
-                    Parser::error(1, fmt::format("invalid value for `-{}={}`", shortkey, value));
-            }
+        // Parse value into result (keyed from static storage, as the token may be refilled)
+        std::string_view key(&SHORTKEYS[static_cast<unsigned char>(shortkey)], 1);
+        if (!this->parseValue(result, idx, value, key, 1)) {
+            if (advanced && match.value->optional())
+                tokens.unget(); // return to previous string
+            else
+                return Error{Errc::Invalid,
+                             fmt::format("invalid value for `-{}={}`", shortkey, value)};
+        }
+        // Parse any remaining values
+        if (match.nargs > 1)
+            return this->parseNargs(tokens, result, idx, "-", key);
+
+        break; // we're done with this string
+    }
+
+    return {};
+}
 
-            break; // we're done with this string
+Expected<void> Parser::parseNargs(Tokens &tokens,
+                                  Result &result,
+                                  std::size_t idx,
+                                  const char *dash,
+                                  std::string_view key) const {
+    // Consume the following strings as values
+    const Slot &match = this->slots[idx];
+    std::string_view value;
+    for (std::size_t n = 1; n < match.nargs; n++) {
+        if (!tokens.next(value))
+            return Error{Errc::Missing, fmt::format("missing value for `{}{}`", dash, key)};
+        if (!this->parseValue(result, idx, value, key, std::strlen(dash)))
+            return Error{Errc::Invalid,
+                         fmt::format("invalid value for `{}{}={}`", dash, key, value)};
+    }
+    return {};
+}
+
+void Parser::reserveRepeated(Result &result) const {
+    // Count occurrences of each option (response file errors are reported when parsing)
+    std::vector<std::size_t> counts(this->slots.size());
+    ArgvSource argv(this->argc, this->argv);
+    EnvSource source(this->app.envargs(), argv);
+    Tokens tokens(source, true);
+    std::string_view arg;
+    while (tokens.next(arg)) {
+        if (arg == "--")
+            break;
+        if (arg.starts_with("--")) {
+            std::string_view s = arg.substr(2);
+            if (auto idx = this->resolve(s.substr(0, s.find('='))))
+                counts[idx.value()]++;
+        } else if (this->commandnames.find(arg) != Index::npos) {
+            break; // remainder belongs to a subcommand
+        } else if (arg.starts_with('-')) {
+            for (char c : arg.substr(1)) {
+                std::size_t idx = this->shortnames[static_cast<unsigned char>(c)];
+                if (idx == Index::npos)
+                    break;
+                counts[idx]++;
+                if (this->slots[idx].kind != Kind::Flag)
+                    break; // remainder is a value
+            }
         }
     }
 
-    return true;
+    // Reserve exactly once for each repeated opt (its default is replaced once matched)
+    for (std::size_t idx : this->opts) {
+        const Slot &slot = this->slots[idx];
+        if (counts[idx] && slot.value->repeated())
+            slot.ops->reserve(result.at(idx), counts[idx] * slot.nargs);
+    }
 }
 
-bool Parser::parseArg(int &i, std::size_t &argidx) {
-    // Extract arg
-    const std::string &name = this->args.at(argidx);
-    AbstractArg *arg = dynamic_cast<AbstractArg *>(this->params.at(name).get());
+Expected<void> Parser::parseArg(Result &result, std::string_view value, std::size_t &argidx) const {
+    // Extract arg (past the last, only when variadic)
+    std::size_t idx = this->args[std::min(argidx, this->args.size() - 1)];
+    const Slot &arg = this->slots[idx];
+    this->match(result, idx);
 
-    // Attempt to parse into `Value`
+    // Attempt to parse into result
     // NOTE: if parse failed on optional arg, continue anyways
-    if (arg->parse(this->argv[i]) || arg->optional())
+    if (this->parseValue(result, idx, value, {}, 0) || arg.value->optional())
         argidx++;
     else
-        Parser::error(1, fmt::format("invalid value for `{}`", name));
+        return Error{Errc::Invalid,
+                     fmt::format("invalid value for `{}`", this->params[idx]->name())};
 
-    return true;
+    return {};
+}
+
+Expected<void> Parser::parseComplete() {
+    // Print completion script
+    std::string_view mode = this->argv[0];
+    if (mode == "--clip-complete-script") {
+        std::string_view shell = this->argc > 1 ? this->argv[1] : "";
+        if (shell != "bash" && shell != "zsh" && shell != "fish")
+            return Error{Errc::Invalid, fmt::format("invalid value for `{}={}`", mode, shell)};
+        return Error{Errc::Complete, this->script_s(shell)};
+    }
+
+    // List candidates for the word at `cword`
+    std::size_t cword;
+    std::string_view s = this->argc > 1 ? this->argv[1] : "";
+    if (!convert(s, cword))
+        return Error{Errc::Invalid, fmt::format("invalid value for `{}={}`", mode, s)};
+    return Error{Errc::Complete, this->complete_s(cword, this->argv + 2, this->argc - 2)};
+}
+
+Expected<void> Parser::parseCommand(Tokens &tokens,
+                                    Result &result,
+                                    std::size_t idx,
+                                    bool layers) const {
+    // Parse remaining tokens into the subcommand's result (reused while the same one is selected),
+    // continuing the same stream so that a `--` in the subcommand stops expansion of the rest
+    Parser &command = this->build(idx);
+    result.command_ = idx;
+    if (!result.sub || result.sub->parser != &command)
+        result.sub = std::make_unique<Result>(command);
+    return command.parseTokens(tokens, *result.sub, layers);
 }
 
 // formatters
 std::string Parser::help_s() const {
-    // Format usage, flags, options, args
-    // clang-format off
-    std::string version = this->version_s();
-    std::string usage   = this->usage_s();
-    std::string flags   = this->flags_s();
-    std::string options = this->opts_s();
-    std::string args    = this->args_s();
-
-    // Format help message
-    std::stringstream ss;
-    ss << version << std::endl;
+    std::string out;
+    this->formatHelp(out, terminalWidth(STDOUT_FILENO));
+    return out;
+}
+
+std::string Parser::usage_s() const {
+    std::string out;
+    this->formatUsage(out);
+    return out;
+}
+
+std::string Parser::flags_s() const {
+    return this->formatEntries(this->flags);
+}
+
+std::string Parser::opts_s() const {
+    return this->formatEntries(this->opts);
+}
+
+std::string Parser::args_s() const {
+    return this->formatEntries(this->args);
+}
+
+std::string Parser::commands_s() const {
+    std::size_t width = terminalWidth(STDOUT_FILENO);
+    std::size_t size = 0;
+    std::size_t column = this->measure(width, size);
+    std::string out;
+    this->formatCommands(out, column, width);
+    return out;
+}
+
+std::string Parser::version_s() const {
+    return fmt::format("{} {}", this->app.name, this->app.version());
+}
+
+std::string Parser::complete_s(std::size_t cword,
+                               const char *const *words,
+                               std::size_t nwords) const {
+    // Walk the preceding words for context (without parsing any values)
+    const Parser *parser = this;
+    bool doneopts = false;
+    std::size_t value = Index::npos; // option whose value is the next word
+    std::size_t argidx = 0;
+    for (std::size_t i = 1; i < cword && i < nwords; i++) {
+        std::string_view word = words[i];
+        if (value != Index::npos) {
+            value = Index::npos;
+            continue;
+        }
+        std::size_t opt = Index::npos; // option which may take the next word
+        if (!doneopts && word == "--") {
+            doneopts = true;
+        } else if (!doneopts && word.starts_with("--")) {
+            if (word.find('=') == std::string_view::npos)
+                if (auto idx = parser->resolve(word.substr(2)))
+                    opt = idx.value();
+        } else if (!doneopts && word.size() > 1 && word.starts_with('-')) {
+            // Find the first option within a cluster to take a value
+            for (std::size_t j = 1; j < word.size(); j++) {
+                opt = parser->shortnames[static_cast<unsigned char>(word[j])];
+                if (opt == Index::npos || parser->slots[opt].kind != Kind::Flag) {
+                    if (j + 1 < word.size())
+                        opt = Index::npos; // value is attached
+                    break;
+                }
+            }
+        } else if (argidx == 0 && parser->commandnames.find(word) != Index::npos) {
+            parser = &parser->build(parser->commandnames.find(word));
+            doneopts = false;
+        } else {
+            argidx++;
+        }
+        if (opt != Index::npos && parser->slots[opt].kind == Kind::Opt &&
+            !parser->slots[opt].value->optional())
+            value = opt;
+    }
+
+    // List candidates for the current word (leaving values to the shell, unless restricted)
+    std::string_view word = cword < nwords ? words[cword] : "";
+    std::string out;
+    if (value != Index::npos) {
+        formatChoices(out, parser->slots[value].value->choices(), "", word);
+    } else if (!doneopts && word.starts_with("--")) {
+        std::size_t eq = word.find('=');
+        if (eq == std::string_view::npos)
+            formatPrefixed(out, parser->sortedlongnames, "--", word.substr(2));
+        else if (auto idx = parser->resolve(word.substr(2, eq - 2)))
+            if (const AbstractValue *match = parser->slots[idx.value()].value)
+                formatChoices(out, match->choices(), word.substr(0, eq + 1), word.substr(eq + 1));
+    } else if (!doneopts && word == "-") {
+        for (std::size_t c = 0; c < parser->shortnames.size(); c++)
+            if (parser->shortnames[c] != Index::npos)
+                out.append(1, '-').append(1, static_cast<char>(c)).append(1, '\n');
+        formatPrefixed(out, parser->sortedlongnames, "--", "");
+    } else if (doneopts || !word.starts_with('-')) {
+        if (!doneopts && argidx == 0)
+            formatPrefixed(out, parser->sortedcommands, "", word);
+        if (argidx < parser->args.size() || parser->variadic) {
+            std::size_t idx = parser->args[std::min(argidx, parser->args.size() - 1)];
+            formatChoices(out, parser->slots[idx].value->choices(), "", word);
+        }
+    }
+    return out;
+}
+
+std::string Parser::script_s(std::string_view shell) const {
+    // Select script
+    const char *script;
+    if (shell == "bash")
+        script = BASH;
+    else if (shell == "zsh")
+        script = ZSH;
+    else if (shell == "fish")
+        script = FISH;
+    else
+        throw std::invalid_argument(fmt::format("unknown shell: `{}`", shell));
+
+    // Name shell function after the app
+    std::string fn = "_clip_" + this->app.name;
+    std::replace_if(fn.begin(), fn.end(), [](unsigned char c) { return !std::isalnum(c); }, '_');
+    return fmt::format(fmt::runtime(script), fmt::arg("name", this->app.name), fmt::arg("fn", fn));
+}
+
+void Parser::printHelp(int fd) const {
+    // Render help into one buffer, then write it all at once
+    std::string out;
+    this->formatHelp(out, terminalWidth(fd));
+    for (std::string_view s = out; !s.empty();) {
+        ssize_t n = ::write(fd, s.data(), s.size());
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        s.remove_prefix(n);
+    }
+}
+
+// formatters (helpers)
+std::size_t Parser::measure(std::size_t width, std::size_t &size) const {
+    // Find the widest entry in one pass, estimating the rendered size along the way
+    std::size_t widest = 0;
+    size = HELPSLACK + this->app.about().size() + this->app.author().size();
+    for (std::size_t idx = 0; idx < this->slots.size(); idx++) {
+        const Slot &slot = this->slots[idx];
+        std::size_t len = 0;
+        if (slot.option)
+            len += 6 + std::strlen(slot.option->longname()); // "-x, --" + longname
+        if (slot.kind == Kind::Opt)
+            len += 1; // space before metavar
+        if (slot.value) {
+            std::size_t metavar = std::strlen(slot.value->metavar()) + 2;
+            len += metavar + (slot.nargs - 1) * (metavar + 1);
+            if (slot.kind == Kind::Opt && slot.value->repeated())
+                len += 3; // "..."
+        }
+        widest = std::max(widest, len);
+        size += len + std::strlen(this->params[idx]->help());
+        if (slot.value)
+            for (std::string_view choice : slot.value->choices())
+                size += choice.size() + 2 + TABWIDTH; // ", " (or a wrapped line)
+    }
+    for (const Command &command : this->commands) {
+        widest = std::max(widest, command.name.size());
+        size += command.name.size() + command.help.size();
+    }
+
+    // Leave a gap before help text (and room to wrap it on narrow terminals)
+    std::size_t limit = MAXCOLUMN;
+    if (width && width < TABWIDTH + MAXCOLUMN + MINWRAP)
+        limit = std::max(MINCOLUMN, width - std::min(width, TABWIDTH + MINWRAP));
+    std::size_t column = std::clamp(widest + 2, MINCOLUMN, limit);
+    size += (this->slots.size() + this->commands.size()) * (column + TABWIDTH + 2);
+    return column;
+}
+
+void Parser::formatHelp(std::string &out, std::size_t width) const {
+    CLIP_STATS_SCOPE(this->stats_);
+    CLIP_STATS_SPAN(help);
+    // Size buffer up front
+    std::size_t size = 0;
+    std::size_t column = this->measure(width, size);
+    out.reserve(out.size() + size);
+    CLIP_STATS_COUNT(strings, 1);
+    CLIP_STATS_COUNT(bytes, size);
+
+    // Format header
+    auto it = std::back_inserter(out);
+    fmt::format_to(it, "{} {}\n", this->app.name, this->app.version());
     if (this->app.author().length())
-        ss << this->app.author() << std::endl;
+        fmt::format_to(it, "{}\n", this->app.author());
     if (this->app.about().length())
-        ss << this->app.about() << std::endl;
-    ss << std::endl;
-    ss << "USAGE: " << std::endl
-       << "\t" << usage << std::endl
-       << std::endl;
-    if (flags.length())
-        ss << "FLAGS:" << std::endl
-           << flags << std::endl;
-    if (options.length())
-        ss << "OPTIONS:" << std::endl
-           << options << std::endl;
-    if (args.length())
-        ss << "ARGS:" << std::endl
-           << args << std::endl;
-    // clang-format on
-    return ss.str();
+        fmt::format_to(it, "{}\n", this->app.about());
+    out += "\nUSAGE: \n\t";
+    this->formatUsage(out);
+    out += "\n\n";
+
+    // Format each section
+    auto section = [&](const char *title, const std::vector<std::size_t> &entries) {
+        if (entries.empty())
+            return;
+        fmt::format_to(it, "{}\n", title);
+        for (std::size_t idx : entries)
+            this->formatEntry(out, idx, column, width);
+        out += '\n';
+    };
+    section("FLAGS:", this->flags);
+    section("OPTIONS:", this->opts);
+    section("ARGS:", this->args);
+    if (this->commands.size()) {
+        out += "COMMANDS:\n";
+        this->formatCommands(out, column, width);
+        out += '\n';
+    }
 }
 
-std::string Parser::usage_s() const {
-    std::stringstream ss;
+void Parser::formatUsage(std::string &out) const {
     // clang-format off
-    ss << this->app.name
-       << (this->flags.size() ? " [FLAGS]"   : "")
-       << (this->opts.size()  ? " [OPTIONS]" : "")
-       << (this->args.size()  ? " <ARGS>"    : "");
+    out += this->app.name;
+    out += this->flags.size()    ? " [FLAGS]"   : "";
+    out += this->opts.size()     ? " [OPTIONS]" : "";
+    out += this->args.size()     ? " <ARGS>"    : "";
+    out += this->commands.size() ? " <COMMAND>" : "";
     // clang-format on
-    return ss.str();
 }
 
-std::string Parser::flags_s() const {
-    const int WIDTH = 16;
-    const std::string FMTWIDTH = fmt::format("{{:{}s}}", WIDTH);
-
-    // Format all flags
-    std::stringstream ss;
-    for (const auto &name : this->flags) {
-        const Flag *flag = dynamic_cast<Flag *>(this->params.at(name).get());
-        // Format shortname
-        std::string fmtshortname = flag->shortname() ? fmt::format("-{}, ", flag->shortname()) :
-                                                       fmt::format("{:4s}", "");
-        // Format longname
-        std::string fmtlongname = fmt::format("--{}", flag->longname());
-        // Format shortname + longname
-        std::string fmtnames = fmtshortname + fmtlongname;
-        if (fmtnames.length() < WIDTH)
-            fmtnames = fmt::format(FMTWIDTH, fmtnames);
-        else
-            fmtnames = fmt::format("{}\n\t" + FMTWIDTH, fmtnames, "");
-        // Append formatted flag
-        ss << fmt::format("\t{}{}\n", fmtnames, flag->help());
-    }
-    return ss.str();
+std::string Parser::formatEntries(const std::vector<std::size_t> &entries) const {
+    std::size_t width = terminalWidth(STDOUT_FILENO);
+    std::size_t size = 0;
+    std::size_t column = this->measure(width, size);
+    std::string out;
+    for (std::size_t idx : entries)
+        this->formatEntry(out, idx, column, width);
+    return out;
 }
 
-std::string Parser::opts_s() const {
-    const int WIDTH = 24;
-    const std::string FMTWIDTH = fmt::format("{{:{}s}}", WIDTH);
-
-    // Format all opts
-    std::stringstream ss;
-    for (const auto &name : this->opts) {
-        const AbstractOpt *opt = dynamic_cast<AbstractOpt *>(this->params.at(name).get());
-        // Format shortname
-        std::string fmtshortname = opt->shortname() ? fmt::format("-{}, ", opt->shortname()) :
-                                                      fmt::format("{:4s}", "");
-        // Format longname
-        std::string fmtlongname = fmt::format("--{} ", opt->longname());
-        // Format metavar
-        std::string fmtmetavar = fmt::format(opt->optional() ? "[{}]" : "<{}>", opt->metavar());
-        // Format shortname + longname + metavar
-        std::string fmtnames = fmtshortname + fmtlongname + fmtmetavar;
-        if (fmtnames.length() < WIDTH)
-            fmtnames = fmt::format(FMTWIDTH, fmtnames);
+void Parser::formatEntry(std::string &out,
+                         std::size_t idx,
+                         std::size_t column,
+                         std::size_t width) const {
+    const Slot &slot = this->slots[idx];
+    out += '\t';
+    std::size_t start = out.size();
+    auto it = std::back_inserter(out);
+
+    // Format shortname + longname
+    if (const Option *option = slot.option) {
+        if (option->shortname())
+            fmt::format_to(it, "-{}, ", option->shortname());
         else
-            fmtnames = fmt::format("{}\n\t" + FMTWIDTH, fmtnames, "");
-        // Append formatted opt
-        ss << fmt::format("\t{}{}\n", fmtnames, opt->help());
+            out.append(4, ' ');
+        fmt::format_to(it, "--{}", option->longname());
+    }
+    // Format metavar
+    if (const AbstractValue *value = slot.value) {
+        if (slot.kind == Kind::Opt)
+            out += ' ';
+        fmt::format_to(it, fmt::runtime(value->optional() ? "[{}]" : "<{}>"), value->metavar());
+        for (std::size_t n = 1; n < slot.nargs; n++)
+            fmt::format_to(it, " <{}>", value->metavar());
+        if (slot.kind == Kind::Opt && value->repeated())
+            out += "...";
     }
-    return ss.str();
+
+    // Format help
+    std::span<const std::string_view> choices;
+    if (slot.value)
+        choices = slot.value->choices();
+    describe(out, start, this->params[idx]->help(), column, width, choices);
 }
 
-std::string Parser::args_s() const {
-    const int WIDTH = 16;
-    const std::string FMTWIDTH = fmt::format("{{:{}s}}", WIDTH);
-
-    // Format all args
-    std::stringstream ss;
-    for (const auto &name : this->args) {
-        const AbstractArg *arg = dynamic_cast<AbstractArg *>(this->params.at(name).get());
-        // Format name
-        std::string fmtmetavar = fmt::format(arg->optional() ? "[{}]" : "<{}>", arg->metavar());
-        if (fmtmetavar.length() < WIDTH)
-            fmtmetavar = fmt::format(FMTWIDTH, fmtmetavar);
-        else
-            fmtmetavar = fmt::format("{}\n\t" + FMTWIDTH, fmtmetavar, "");
-        // Append formatted arg
-        ss << fmt::format("\t{}{}\n", fmtmetavar, arg->help());
+void Parser::formatCommands(std::string &out, std::size_t column, std::size_t width) const {
+    // Format all commands (without building them)
+    for (const Command &command : this->commands) {
+        out += '\t';
+        std::size_t start = out.size();
+        out += command.name;
+        describe(out, start, command.help, column, width);
     }
-    return ss.str();
 }
 
-std::string Parser::version_s() const {
-    return fmt::format("{} {}", this->app.name, this->app.version());
+void Parser::formatPrefixed(std::string &out,
+                            const Sorted &sorted,
+                            std::string_view dash,
+                            std::string_view prefix) {
+    // Format each name starting with prefix (adjacent once sorted)
+    auto it = std::lower_bound(
+        sorted.begin(), sorted.end(), prefix, [](const auto &key, std::string_view prefix) {
+            return key.first < prefix;
+        });
+    for (; it != sorted.end() && it->first.starts_with(prefix); ++it)
+        out.append(dash).append(it->first).append(1, '\n');
 }
 
-// explicit instantiations
-// clang-format off
-template Parser &Parser::add(const Opt<double>      &opt);
-template Parser &Parser::add(const Opt<int>         &opt);
-template Parser &Parser::add(const Opt<std::string> &opt);
-template Parser &Parser::add(const Arg<double>      &arg);
-template Parser &Parser::add(const Arg<int>         &arg);
-template Parser &Parser::add(const Arg<std::string> &arg);
-template const Flag             &Parser::get(const char *name) const;
-template const Opt<double>      &Parser::get(const char *name) const;
-template const Opt<int>         &Parser::get(const char *name) const;
-template const Opt<std::string> &Parser::get(const char *name) const;
-template const Arg<double>      &Parser::get(const char *name) const;
-template const Arg<int>         &Parser::get(const char *name) const;
-template const Arg<std::string> &Parser::get(const char *name) const;
-template const Opt<double>      &Parser::getOpt(const char *name) const;
-template const Opt<int>         &Parser::getOpt(const char *name) const;
-template const Opt<std::string> &Parser::getOpt(const char *name) const;
-template const Arg<double>      &Parser::getArg(const char *name) const;
-template const Arg<int>         &Parser::getArg(const char *name) const;
-template const Arg<std::string> &Parser::getArg(const char *name) const;
-// clang-format on
+void Parser::formatChoices(std::string &out,
+                           std::span<const std::string_view> choices,
+                           std::string_view lead,
+                           std::string_view prefix) {
+    // Format each choice starting with prefix (in declared order)
+    for (std::string_view choice : choices)
+        if (choice.starts_with(prefix))
+            out.append(lead).append(choice).append(1, '\n');
+}
 
 } // namespace clip
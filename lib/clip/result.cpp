@@ -0,0 +1,154 @@
+//
+//  result.cpp
+//  Command line interface parse result.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include "clip/result.h"
+
+#include <fmt/core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include "clip/app.h"
+#include "clip/index.h"
+#include "clip/parser.h"
+#include "clip/stats.h"
+
+namespace clip {
+
+// class Result
+// ctors
+Result::Result(const Parser &parser) :
+    parser(&parser),
+    generation(parser.generation),
+    storage(nullptr),
+    placed(),
+    touched(),
+    command_(Index::npos),
+    sub(),
+    deferred(),
+    pending(),
+    deferring(false) {
+    // Check parser has been laid out
+    if (!parser.frozen)
+        throw std::logic_error("parser must be frozen");
+
+    // Allocate storage, zeroing counts and copying in defaults
+    CLIP_STATS_SCOPE(parser.stats_);
+    CLIP_STATS_COUNT(bytes, parser.footprint);
+    this->storage = static_cast<std::byte *>(
+        ::operator new(parser.footprint, std::align_val_t(ALIGN)));
+    std::memset(this->storage, 0, parser.slots.size() * sizeof(std::uint32_t));
+    this->placed.reserve(parser.slots.size());
+    for (std::size_t idx = 0; idx < parser.slots.size(); idx++) {
+        const Parser::Slot &slot = parser.slots[idx];
+        if (!slot.ops)
+            continue;
+        slot.ops->init(this->at(idx), slot.object);
+        this->placed.push_back(Placed{slot.ops->destroy, slot.offset});
+    }
+    this->touched.reserve(parser.slots.size());
+}
+
+Result::Result(Result &&other) noexcept :
+    parser(other.parser),
+    generation(other.generation),
+    storage(other.storage),
+    placed(std::move(other.placed)),
+    touched(std::move(other.touched)),
+    command_(other.command_),
+    sub(std::move(other.sub)),
+    deferred(std::move(other.deferred)),
+    pending(std::move(other.pending)),
+    deferring(other.deferring) {
+    other.storage = nullptr;
+}
+
+// dtor
+Result::~Result() {
+    if (!this->storage)
+        return;
+    for (const Placed &placed : this->placed)
+        placed.destroy(this->storage + placed.offset);
+    ::operator delete(this->storage, std::align_val_t(ALIGN));
+}
+
+// accessors
+const App &Result::app() const {
+    return this->parser->app;
+}
+
+unsigned int Result::count(const char *name) const {
+    return this->counts()[this->find(name)];
+}
+
+const Result *Result::command() const {
+    this->check();
+    return this->command_ != Index::npos ? this->sub.get() : nullptr;
+}
+
+// methods
+void Result::reset() {
+    this->check();
+
+    // Restore touched slots (dropping any deferred values)
+    std::uint32_t *counts = this->counts();
+    for (std::size_t idx : this->touched) {
+        counts[idx] = 0;
+        if (!this->pending.empty())
+            this->pending[idx] = 0;
+        const Parser::Slot &slot = this->parser->slots[idx];
+        if (slot.ops)
+            slot.ops->assign(this->at(idx), slot.object);
+    }
+    this->touched.clear();
+    this->deferred.clear();
+
+    // Deselect subcommand (keeping its result for reuse)
+    this->command_ = Index::npos;
+    if (this->sub)
+        this->sub->reset();
+}
+
+// accessors
+void Result::check() const {
+    if (this->generation != this->parser->generation)
+        throw std::logic_error("result predates its parser's layout");
+}
+
+std::uint32_t *Result::counts() const {
+    return reinterpret_cast<std::uint32_t *>(this->storage);
+}
+
+void *Result::at(std::size_t idx) const {
+    return this->storage + this->parser->slots[idx].offset;
+}
+
+const void *Result::at(const char *name, const void *type) const {
+    // Check requested type
+    std::size_t idx = this->find(name);
+    const Parser::Ops *ops = this->parser->slots[idx].ops;
+    if (!ops || ops->type != type)
+        throw std::invalid_argument(fmt::format("type mismatch for param: `{}`", name));
+    return this->at(idx);
+}
+
+std::size_t Result::find(const char *name) const {
+    this->check();
+    std::size_t idx = this->parser->names.find(name);
+    if (idx == Index::npos)
+        throw std::out_of_range(fmt::format("unknown param: `{}`", name));
+    return idx;
+}
+
+} // namespace clip
@@ -0,0 +1,266 @@
+//
+//  schema.cpp
+//  Command line interface compile-time schema.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include "clip/schema.h"
+
+#include <fmt/core.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "clip/app.h"
+#include "clip/arg.h"
+#include "clip/error.h"
+#include "clip/flag.h"
+#include "clip/hash.h"
+#include "clip/opt.h"
+#include "clip/parser.h"
+#include "clip/token.h"
+
+namespace clip {
+namespace detail {
+
+namespace {
+
+// Search for the option with this longname
+std::size_t findLong(const SchemaView &schema, std::string_view key) {
+    if (key.empty())
+        return hash::EMPTY;
+    std::uint32_t i = schema.table[hash::slot(hash::fnv1a(key), schema.disps, schema.table.size())];
+    return (i != hash::EMPTY && schema.specs[i].longname() == key) ? i : hash::EMPTY;
+}
+
+// Search for the next positional arg
+std::size_t findArg(const SchemaView &schema, std::size_t from) {
+    for (std::size_t i = from; i < schema.specs.size(); i++)
+        if (schema.specs[i].kind == Spec::Kind::Arg)
+            return i;
+    return hash::EMPTY;
+}
+
+// Check for automatic flags (unless taken by the schema's own params), as `Parser` adds them
+Expected<void> checkAutoflags(const SchemaView &schema, const App &app, std::string_view name) {
+    auto taken = [&](const Spec &spec) { return spec.name == name || spec.longname() == name; };
+    if (std::any_of(schema.specs.begin(), schema.specs.end(), taken))
+        return {};
+    if (name == "help")
+        return Error{Errc::Help, "help requested"};
+    if (name == "version" && !app.version().empty())
+        return Error{Errc::Version, "version requested"};
+    return {};
+}
+
+// Take an option's value, attached or else from the next string (as `Parser` does)
+Expected<void> takeValue(const Spec &spec,
+                         Tokens &tokens,
+                         std::string_view value,
+                         bool attached,
+                         std::string_view dash,
+                         std::string_view key,
+                         std::string_view &out) {
+    // Either use the attached value, or the next string
+    if (!attached && !tokens.next(value)) {
+        if (spec.optional())
+            return {}; // we don't need a value
+        return Error{Errc::Missing, fmt::format("missing value for `{}{}`", dash, key)};
+    }
+
+    // Check value against its type
+    if (!spec.check(value)) {
+        if (!attached && spec.optional()) {
+            tokens.unget(); // return to previous string
+            return {};
+        }
+        return Error{Errc::Invalid, fmt::format("invalid value for `{}{}={}`", dash, key, value)};
+    }
+    out = value;
+    return {};
+}
+
+Expected<void> parseLongOption(const SchemaView &schema,
+                               const App &app,
+                               Tokens &tokens,
+                               std::string_view arg,
+                               unsigned int *counts,
+                               std::string_view *values) {
+    // Extract from argument
+    std::string_view s = arg.substr(2);
+    std::size_t eq = s.find('=');
+    std::string_view longkey = s.substr(0, eq);
+    std::string_view value = (eq != std::string_view::npos) ? s.substr(eq + 1) : std::string_view();
+    // Search for a match
+    std::size_t idx = findLong(schema, longkey);
+    if (idx == hash::EMPTY) {
+        if (auto status = checkAutoflags(schema, app, longkey); !status)
+            return status;
+        return Error{Errc::Unknown, fmt::format("illegal option: `--{}`", longkey)};
+    }
+    const Spec &spec = schema.specs[idx];
+    counts[idx]++;
+
+    // Take value of options
+    if (spec.kind != Spec::Kind::Opt)
+        return {};
+    return takeValue(spec, tokens, value, !value.empty(), "--", longkey, values[idx]);
+}
+
+Expected<void> parseShortOption(const SchemaView &schema,
+                                const App &app,
+                                Tokens &tokens,
+                                std::string_view arg,
+                                unsigned int *counts,
+                                std::string_view *values) {
+    // Look through each character
+    for (std::size_t j = 1; j < arg.size(); j++) {
+        char shortkey = arg[j];
+        // Search for a match
+        std::size_t idx = schema.shortnames[static_cast<unsigned char>(shortkey)];
+        if (idx == hash::EMPTY) {
+            std::string_view name = shortkey == 'h' ? "help" : shortkey == 'V' ? "version" : "";
+            if (auto status = checkAutoflags(schema, app, name); !status)
+                return status;
+            return Error{Errc::Unknown, fmt::format("illegal option: `-{}`", shortkey)};
+        }
+        const Spec &spec = schema.specs[idx];
+        counts[idx]++;
+
+        // Take value of options from the rest of this string (skipping any '='), or the next
+        if (spec.kind != Spec::Kind::Opt)
+            continue;
+        std::string_view value = arg.substr(j + 1);
+        bool attached = !value.empty();
+        if (value.starts_with('='))
+            value.remove_prefix(1);
+        std::string_view key(&CHARS[static_cast<unsigned char>(shortkey)], 1);
+        return takeValue(spec, tokens, value, attached, "-", key, values[idx]);
+    }
+    return {};
+}
+
+// Add a param described by `spec` to `parser` (for rendering help)
+template <typename P>
+void describe(Parser &parser, P param, const Spec &spec) {
+    if (!spec.help().empty())
+        param.help(std::string(spec.help()).data());
+    if constexpr (std::is_base_of_v<Option, P>) {
+        if (spec.longname() != spec.name)
+            param.longname(std::string(spec.longname()).data());
+        if (spec.shortname())
+            param.shortname(spec.shortname());
+    }
+    if constexpr (std::is_base_of_v<AbstractValue, P>) {
+        if (!spec.metavar().empty())
+            param.metavar(std::string(spec.metavar()).data());
+        param.optional(spec.optional());
+    }
+    parser.add(std::move(param));
+}
+
+} // namespace
+
+Expected<void> parse(const SchemaView &schema,
+                     const App &app,
+                     Tokens &tokens,
+                     unsigned int *counts,
+                     std::string_view *values) {
+    // Skip options after finding "--" terminator
+    bool doneopts = false;
+    // Keep track of the next positional arg
+    std::size_t argidx = findArg(schema, 0);
+    // Keep track of whether any arguments were supplied
+    bool empty = true;
+
+    // Parse each argument as it arrives (expanding response files)
+    std::string_view arg;
+    while (tokens.next(arg)) {
+        empty = false;
+
+        // clang-format off
+        Expected<void> status;
+        // Match option terminator
+        if (!doneopts && arg == "--") {
+            doneopts = true;
+            tokens.verbatim(); // response files too are taken literally
+        }
+        // Match long options
+        else if (!doneopts && arg.starts_with("--"))
+            status = parseLongOption(schema, app, tokens, arg, counts, values);
+        // Match short options
+        else if (!doneopts && arg.size() > 1 && arg.starts_with("-"))
+            status = parseShortOption(schema, app, tokens, arg, counts, values);
+        // Match positional arguments (skipping invalid values of optional ones)
+        else if (argidx != hash::EMPTY) {
+            const Spec &spec = schema.specs[argidx];
+            counts[argidx]++;
+            if (spec.check(arg))
+                values[argidx] = arg;
+            else if (!spec.optional())
+                status = Error{Errc::Invalid, fmt::format("invalid value for `{}`", spec.name)};
+            argidx = findArg(schema, argidx + 1);
+        }
+        // Handle extra values
+        else
+            status = Error{Errc::Unexpected, fmt::format("unexpected token: `{}`", arg)};
+        // clang-format on
+
+        // Stop at the first error (preferring errors from response files)
+        if (!status)
+            return tokens.error() ? *tokens.error() : status;
+    }
+    if (tokens.error())
+        return *tokens.error();
+
+    // Show help if no arguments supplied (unless some are required)
+    auto required = [](const Spec &spec) {
+        return spec.kind == Spec::Kind::Arg && !spec.optional();
+    };
+    if (empty && std::none_of(schema.specs.begin(), schema.specs.end(), required))
+        return Error{Errc::Usage, "no arguments supplied"};
+
+    // Handle missing arguments
+    if (argidx != hash::EMPTY)
+        return Error{Errc::Missing, "missing arguments"};
+
+    return {};
+}
+
+void exit(const SchemaView &schema, const App &app, const Error &error) {
+    // Print requested output, or report error
+    switch (error.code) {
+        case Errc::Help:
+        case Errc::Usage: {
+            // Render help through an equivalent parser (only now allocating one)
+            Parser parser(app);
+            for (const Spec &spec : schema.specs) {
+                std::string name(spec.name);
+                switch (spec.kind) {
+                    case Kind::Flag: describe(parser, Flag(name.data()), spec); break;
+                    case Kind::Opt: describe(parser, Opt<std::string>(name.data()), spec); break;
+                    case Kind::Arg: describe(parser, Arg<std::string>(name.data()), spec); break;
+                }
+            }
+            parser.freeze();
+            std::cout.flush(), parser.printHelp(STDOUT_FILENO);
+            break;
+        }
+        case Errc::Version: std::cout << app.name << " " << app.version() << std::endl; break;
+        default: Parser::error(error.status(), error.message);
+    }
+    std::exit(error.status());
+}
+
+} // namespace detail
+} // namespace clip
@@ -0,0 +1,131 @@
+//
+//  stats.cpp
+//  Command line interface parse statistics.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include "clip/stats.h"
+
+#ifdef CLIP_STATS
+
+#include <fmt/core.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace clip::stats {
+
+namespace {
+
+// Completed span
+struct Event {
+    const char *name;
+    Clock::time_point start;
+    Clock::time_point end;
+    pid_t tid;
+};
+
+// Spans recorded by every thread, written out at exit
+class Recorder final {
+private:
+    // impl members
+    std::string path;
+    std::atomic<bool> enabled_;
+    std::mutex mutex;
+    std::vector<Event> events;
+
+public:
+    // ctors
+    Recorder() : path(), enabled_(false), mutex(), events() {
+        if (const char *path = std::getenv("CLIP_TRACE"))
+            this->output(path);
+    }
+
+    // dtor
+    ~Recorder() {
+        if (this->path.empty())
+            return;
+        std::FILE *file = std::fopen(this->path.c_str(), "w");
+        if (!file)
+            return;
+        // Write trace events (in microseconds since the first)
+        const pid_t pid = ::getpid();
+        Clock::time_point epoch = Clock::time_point::max();
+        for (const Event &event : this->events)
+            epoch = std::min(epoch, event.start);
+        fmt::print(file, "{{\"traceEvents\":[");
+        for (std::size_t i = 0; i < this->events.size(); i++) {
+            const Event &event = this->events[i];
+            using us = std::chrono::duration<double, std::micro>;
+            fmt::print(file,
+                       "{}\n{{\"name\":\"{}\",\"cat\":\"clip\",\"ph\":\"X\",\"ts\":{:.3f},"
+                       "\"dur\":{:.3f},\"pid\":{},\"tid\":{}}}",
+                       i ? "," : "",
+                       event.name,
+                       us(event.start - epoch).count(),
+                       us(event.end - event.start).count(),
+                       pid,
+                       event.tid);
+        }
+        fmt::print(file, "\n]}}\n");
+        std::fclose(file);
+    }
+
+    // accessors
+    bool enabled() const {
+        return this->enabled_.load(std::memory_order_relaxed);
+    }
+
+    // methods
+    void output(const char *path) {
+        std::lock_guard lock(this->mutex);
+        this->path = path;
+        this->enabled_.store(!this->path.empty(), std::memory_order_relaxed);
+    }
+
+    void record(const Event &event) {
+        std::lock_guard lock(this->mutex);
+        this->events.push_back(event);
+    }
+};
+
+Recorder &recorder() {
+    static Recorder recorder;
+    return recorder;
+}
+
+} // namespace
+
+thread_local Stats *current = nullptr;
+
+void count(std::uint64_t Stats::*field, std::uint64_t n) {
+    // Results may be parsed into from several threads at once
+    if (current)
+        std::atomic_ref(current->*field).fetch_add(n, std::memory_order_relaxed);
+}
+
+void trace(const char *name, Clock::time_point start, Clock::time_point end) {
+    if (Recorder &recorder = stats::recorder(); recorder.enabled())
+        recorder.record(Event{name, start, end, ::gettid()});
+}
+
+void output(const char *path) {
+    recorder().output(path);
+}
+
+} // namespace clip::stats
+
+#endif
@@ -0,0 +1,108 @@
+//
+//  text.cpp
+//  Command line interface text storage.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include "clip/text.h"
+
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "clip/stats.h"
+
+namespace clip {
+
+// class Text::Scope
+// ctors
+Text::Scope::Scope(std::pmr::memory_resource *mr) : prev(Text::arena) {
+    Text::arena = mr;
+}
+
+// dtor
+Text::Scope::~Scope() {
+    Text::arena = this->prev;
+}
+
+// class Text
+// impl members
+thread_local std::pmr::memory_resource *Text::arena = nullptr;
+
+// ctors
+Text::Text() : owned(), borrowed() {}
+
+Text::Text(const char *s) : owned(s), borrowed() {}
+
+Text::Text(const Text &other) : owned(), borrowed(other.borrowed) {
+    // Copy owned text into the current arena, if any, rather than into a string of its own
+    if (other.borrowed.data() || other.owned.empty())
+        return;
+    if (Text::arena)
+        this->place(other.owned, Text::arena);
+    else
+        this->owned = other.owned;
+}
+
+// builders
+Text &Text::assign(const char *s) {
+    this->owned = s;
+    this->borrowed = std::string_view();
+    return *this;
+}
+
+Text &Text::assign(std::string &&s) {
+    this->owned = std::move(s);
+    this->borrowed = std::string_view();
+    return *this;
+}
+
+Text &Text::borrow(const char *s) {
+    this->owned = std::string();
+    this->borrowed = s;
+    return *this;
+}
+
+// accessors
+const char *Text::data() const {
+    return this->borrowed.data() ? this->borrowed.data() : this->owned.data();
+}
+
+std::size_t Text::size() const {
+    return this->borrowed.data() ? this->borrowed.size() : this->owned.size();
+}
+
+bool Text::empty() const {
+    return !this->size();
+}
+
+// methods
+void Text::intern(std::pmr::memory_resource *mr) {
+    // Only owned text needs moving (and empty text has no characters)
+    if (this->borrowed.data() || this->owned.empty())
+        return;
+    this->place(this->owned, mr);
+    // Release owned storage
+    std::string().swap(this->owned);
+}
+
+// helpers
+void Text::place(std::string_view s, std::pmr::memory_resource *mr) {
+    // Copy characters (with terminator) into the arena, borrowing them from there
+    std::size_t n = s.size();
+    char *p = static_cast<char *>(mr->allocate(n + 1, alignof(char)));
+    std::memcpy(p, s.data(), n);
+    p[n] = '\0';
+    this->borrowed = std::string_view(p, n);
+    CLIP_STATS_COUNT(strings, 1);
+    CLIP_STATS_COUNT(bytes, n + 1);
+}
+
+} // namespace clip
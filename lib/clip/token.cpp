@@ -0,0 +1,333 @@
+//
+//  token.cpp
+//  Command line interface token streams.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include "clip/token.h"
+
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "clip/error.h"
+#include "clip/stats.h"
+
+namespace clip {
+
+namespace {
+
+// Token separators
+constexpr bool space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+} // namespace
+
+// class Source
+// dtor
+Source::~Source() = default;
+
+// accessors
+bool Source::stable() const {
+    return false;
+}
+
+// class ArgvSource
+// ctors
+ArgvSource::ArgvSource(int argc, const char *const *argv) : argv(argv), end(argv + argc) {}
+
+// accessors
+bool ArgvSource::stable() const {
+    return true;
+}
+
+// methods
+bool ArgvSource::next(std::string_view &token) {
+    if (this->argv == this->end)
+        return false;
+    token = *this->argv++;
+    return true;
+}
+
+// class BufferSource
+// ctors
+BufferSource::BufferSource(std::string_view buffer, char delim) : buffer(buffer), delim(delim) {}
+
+// accessors
+bool BufferSource::stable() const {
+    return true;
+}
+
+// methods
+bool BufferSource::next(std::string_view &token) {
+    if (this->buffer.empty())
+        return false;
+    std::size_t end = this->buffer.find(this->delim);
+    token = this->buffer.substr(0, end);
+    this->buffer.remove_prefix(end == std::string_view::npos ? this->buffer.size() : end + 1);
+    return true;
+}
+
+// class FdSource
+// ctors
+FdSource::FdSource(int fd, char delim) :
+    fd(fd),
+    delim(delim),
+    chunk(CHUNK),
+    pos(0),
+    len(0),
+    tokens(),
+    which(0),
+    eof(false) {}
+
+// methods
+bool FdSource::next(std::string_view &token) {
+    // Assemble token into the buffer not holding the previous one
+    std::string &buffer = this->tokens[this->which ^= 1];
+    buffer.clear();
+    bool found = false;
+    for (;;) {
+        // Read more input as needed
+        if (this->pos == this->len && !this->fill())
+            break;
+        // Append up to the next delimiter
+        const char *begin = this->chunk.data() + this->pos;
+        const char *end = this->chunk.data() + this->len;
+        const char *delim = std::find(begin, end, this->delim);
+        buffer.append(begin, delim);
+        found = true;
+        this->pos = delim - this->chunk.data();
+        if (delim != end) {
+            this->pos++; // skip delimiter
+            break;
+        }
+    }
+    token = buffer;
+    return found;
+}
+
+// helpers
+bool FdSource::fill() {
+    // Read next chunk, retrying on interrupts
+    while (!this->eof) {
+        ssize_t n = ::read(this->fd, this->chunk.data(), this->chunk.size());
+        if (n > 0) {
+            this->pos = 0;
+            this->len = n;
+            return true;
+        }
+        if (!n)
+            this->eof = true;
+        else if (errno != EINTR)
+            throw std::system_error(errno, std::generic_category(), "read");
+    }
+    return false;
+}
+
+// class FileSource
+// ctors
+FileSource::FileSource(const char *path, bool raw) :
+    data(nullptr),
+    size(0),
+    pos(nullptr),
+    dev_(0),
+    ino_(0),
+    raw(raw) {
+    // Open file
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), path);
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), path);
+    }
+    this->dev_ = st.st_dev;
+    this->ino_ = st.st_ino;
+    this->size = st.st_size;
+
+    // Map file privately (unescaping writes only touch our copy)
+    if (this->size) {
+        void *map = ::mmap(nullptr, this->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), path);
+        }
+        ::madvise(map, this->size, MADV_SEQUENTIAL);
+        this->data = static_cast<char *>(map);
+    }
+    this->pos = this->data;
+    ::close(fd);
+}
+
+// dtor
+FileSource::~FileSource() {
+    if (this->data)
+        ::munmap(this->data, this->size);
+}
+
+// accessors
+bool FileSource::same(const FileSource &other) const {
+    return this->dev_ == other.dev_ && this->ino_ == other.ino_;
+}
+
+bool FileSource::stable() const {
+    return true;
+}
+
+// methods
+bool FileSource::next(std::string_view &token) {
+    char *end = this->data + this->size;
+    // Skip leading separators
+    while (this->pos < end && space(*this->pos))
+        this->pos++;
+    if (this->pos == end)
+        return false;
+
+    // Scan token, compacting unescaped characters towards its start
+    char *start = this->pos;
+    char *out = start;
+    char quote = '\0';
+    for (; this->pos < end; this->pos++) {
+        char c = *this->pos;
+        if (quote) {
+            if (c == quote) {
+                quote = '\0';
+                continue;
+            }
+            if (c == '\\' && quote == '"' && this->pos + 1 < end)
+                c = *++this->pos;
+        } else if (space(c)) {
+            break;
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+            continue;
+        } else if (c == '\\' && this->pos + 1 < end) {
+            c = *++this->pos;
+        }
+        // Only write once characters have shifted (avoids copying clean pages)
+        if (!this->raw && out != this->pos)
+            *out = c;
+        out++;
+    }
+
+    // Return a view of the token
+    token = this->raw ? std::string_view(start, this->pos - start) :
+                        std::string_view(start, out - start);
+    return true;
+}
+
+// class Tokens
+// ctors
+Tokens::Tokens(Source &source, bool raw) :
+    source(source),
+    files(),
+    stack(),
+    last(),
+    pending(false),
+    raw(raw),
+    expanding(true),
+    error_() {}
+
+// accessors
+const std::optional<Error> &Tokens::error() const {
+    return this->error_;
+}
+
+bool Tokens::stable() const {
+    return this->source.stable();
+}
+
+// methods
+bool Tokens::next(std::string_view &token) {
+    CLIP_STATS_TIME(tokenize);
+    // Return a pushed back token
+    if (this->pending) {
+        this->pending = false;
+        token = this->last;
+        return true;
+    }
+
+    for (;;) {
+        // Read from the innermost source
+        Source &source = this->stack.empty() ? this->source : *this->stack.back();
+        if (!source.next(token)) {
+            if (this->stack.empty())
+                return false;
+            this->stack.pop_back();
+            continue;
+        }
+        // Expand response files
+        if (this->expanding && token.size() > 1 && token[0] == '@' &&
+            this->expand(token.substr(1)))
+            continue;
+        if (this->error_)
+            return false;
+        this->last = token;
+        CLIP_STATS_COUNT(tokens, 1);
+        return true;
+    }
+}
+
+void Tokens::unget() {
+    this->pending = true;
+}
+
+void Tokens::verbatim() {
+    this->expanding = false;
+}
+
+std::vector<std::unique_ptr<FileSource>> Tokens::release() {
+    this->stack.clear();
+    return std::move(this->files);
+}
+
+// helpers
+bool Tokens::expand(std::string_view path) {
+    // Map file, passing through literally if it cannot be read
+    std::unique_ptr<FileSource> file;
+    try {
+        file = std::make_unique<FileSource>(std::string(path).data(), this->raw);
+    } catch (const std::system_error &) {
+        return false;
+    }
+
+    // Check for cycles and runaway nesting
+    auto same = [&](const FileSource *open) { return open->same(*file); };
+    const char *problem = nullptr;
+    if (std::any_of(this->stack.begin(), this->stack.end(), same))
+        problem = "response file includes itself";
+    else if (this->stack.size() >= DEPTH)
+        problem = "response files nested too deeply";
+    if (problem) {
+        this->error_ = Error{Errc::Response, fmt::format("{}: `@{}`", problem, path)};
+        return false;
+    }
+
+    // Read from file next
+    this->stack.push_back(file.get());
+    this->files.push_back(std::move(file));
+    return true;
+}
+
+} // namespace clip
@@ -12,20 +12,28 @@
 
 #include <algorithm>
 #include <cctype>
-#include <cstdlib>
+#include <memory_resource>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include "clip/param.h"
+#include "clip/text.h"
 
 namespace clip {
 
 // class AbstractValue
 // ctors
-AbstractValue::AbstractValue(const char *name) : Param(name), metavar_(""), optional_(false) {
-    // Set default metavar
+AbstractValue::AbstractValue(const char *name, std::span<const std::string_view> choices) :
+    Param(name),
+    choices_(choices),
+    metavar_(),
+    optional_(false) {
+    // Set default metavar (always owned, as it is derived)
     std::string metavar(name);
     std::transform(metavar.begin(), metavar.end(), metavar.begin(), ::toupper);
-    this->metavar(metavar.data());
+    this->metavar_.assign(std::move(metavar));
 }
 
 // dtor
@@ -33,7 +41,10 @@ AbstractValue::~AbstractValue() = default;
 
 // builders
 AbstractValue &AbstractValue::metavar(const char *s) {
-    this->metavar_ = std::string(s);
+    if (this->borrow())
+        this->metavar_.borrow(s);
+    else
+        this->metavar_.assign(s);
     return *this;
 }
 
@@ -57,85 +68,14 @@ bool AbstractValue::optional() const {
     return this->optional_;
 }
 
-// class Value<T>
-// ctors
-template <typename T>
-Value<T>::Value(const char *name) : Param(name), AbstractValue(name) {}
-
-// dtor
-template <typename T>
-Value<T>::~Value() = default;
-
-// builders
-template <typename T>
-Value<T> &Value<T>::value(const T &value) {
-    this->value_ = value;
-    return *this;
-}
-
-// builders (override)
-template <typename T>
-Value<T> &Value<T>::help(const char *s) {
-    this->AbstractValue::help(s);
-    return *this;
-}
-
-template <typename T>
-Value<T> &Value<T>::metavar(const char *s) {
-    this->AbstractValue::metavar(s);
-    return *this;
-}
-
-template <typename T>
-Value<T> &Value<T>::optional(bool b) {
-    this->AbstractValue::optional(b);
-    return *this;
-}
-
-// accessors
-template <typename T>
-const T &Value<T>::value() const {
-    return this->value_;
+std::span<const std::string_view> AbstractValue::choices() const {
+    return this->choices_;
 }
 
 // methods
-// explicit specializations
-template <>
-bool Value<double>::parse(const char *s) {
-    try {
-        char *endstr;
-        double value_ = std::strtod(s, &endstr);
-        bool success = !*endstr; // check entire string was parsed
-        if (success)
-            this->value_ = value_;
-        return success;
-    } catch (...) { return false; }
-}
-
-template <>
-bool Value<int>::parse(const char *s) {
-    try {
-        char *endstr;
-        int value_ = std::strtol(s, &endstr, 10);
-        bool success = !*endstr; // check entire string was parsed
-        if (success)
-            this->value_ = value_;
-        return success;
-    } catch (...) { return false; }
+void AbstractValue::intern(std::pmr::memory_resource *mr) {
+    this->Param::intern(mr);
+    this->metavar_.intern(mr);
 }
 
-template <>
-bool Value<std::string>::parse(const char *s) {
-    std::string value_ = s;
-    bool success = !value_.empty(); // check string is not empty
-    if (success)
-        this->value_ = value_;
-    return success;
-}
-
-// explicit instantiations
-template class Value<double>;
-template class Value<int>;
-template class Value<std::string>;
-
 } // namespace clip
@@ -40,11 +40,11 @@ int main(int argc, char *argv[]) {
 
     // Print supplied args
     if (d.count())
-        cout << d.name << ": .count = " << d.count() << ", .value = " << d.value() << endl;
+        cout << d.name() << ": .count = " << d.count() << ", .value = " << d.value() << endl;
     if (i.count())
-        cout << i.name << ": .count = " << i.count() << ", .value = " << i.value() << endl;
+        cout << i.name() << ": .count = " << i.count() << ", .value = " << i.value() << endl;
     if (s.count())
-        cout << s.name << ": .count = " << s.count() << ", .value = " << s.value() << endl;
+        cout << s.name() << ": .count = " << s.count() << ", .value = " << s.value() << endl;
     if (f.count())
-        cout << f.name << ": .count = " << f.count() << endl;
+        cout << f.name() << ": .count = " << f.count() << endl;
 }
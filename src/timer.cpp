@@ -10,6 +10,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <thread>
 
@@ -17,6 +18,14 @@
 
 using namespace std;
 
+// Settings bound to the parser's params
+struct Config {
+    double delay;
+    int repeat;
+    string message;
+    unsigned int verbose;
+};
+
 int main(int argc, char *argv[]) {
     // Create parser
     clip::Parser parser(argc,
@@ -25,47 +34,46 @@ int main(int argc, char *argv[]) {
                             .about("My awesome timer app. Parsed by clip!")
                             .author("Zakhary Kaplan <zakharykaplan@gmail.com>")
                             .version("0.1.0"));
-    // Add parser options
+    // Add parser options, each bound to a field of the config
+    Config config;
     parser.add(clip::Opt<int>("repeat")
                    .shortname('n')
                    .metavar("INT")
                    .help("Number of times to repeat the delay.")
-                   .value(1));
+                   .value(1)
+                   .range(0, numeric_limits<int>::max())
+                   .bind(&config.repeat));
     parser.add(clip::Opt<string>("message")
                    .shortname('m')
                    .help("Message to print after each delay.")
                    .metavar("STRING")
-                   .value("Time's up!"));
-    parser.add(clip::Arg<double>("delay").help("Desired delay length (in seconds).").value(0.));
-    parser.add(clip::Flag("verbose").shortname('v').help("Set verbosity level."));
-    // Parse args
+                   .value("Time's up!")
+                   .bind(&config.message));
+    parser.add(clip::Arg<double>("delay")
+                   .help("Desired delay length (in seconds).")
+                   .value(0.)
+                   .range(0., numeric_limits<double>::infinity())
+                   .bind(&config.delay));
+    parser.add(clip::Flag("verbose")
+                   .shortname('v')
+                   .help("Set verbosity level.")
+                   .bind(&config.verbose));
+    // Parse args (validating ranges and storing them into the config)
     parser.parse();
 
-    // Retrieve args
-    const auto &delay = parser.getArg<double>("delay");
-    const auto &repeat = parser.getOpt<int>("repeat");
-    const auto &message = parser.getOpt<string>("message");
-    const auto &verbose = parser.getFlag("verbose");
-
-    // Validate args
-    if (delay.value() < 0)
-        clip::Parser::error(1, "delay must be greater than 0");
-    if (repeat.value() < 0)
-        clip::Parser::error(1, "repeat must be greater than 0");
-
     // Handle verbose output
-    if (verbose.count()) // any verbosity level
-        cout << "Setting " << repeat.value() << " timers for " << delay.value() << " seconds."
+    if (config.verbose) // any verbosity level
+        cout << "Setting " << config.repeat << " timers for " << config.delay << " seconds."
              << endl;
 
     // Repeat for each timer
-    chrono::duration<double> dur(delay.value());
-    for (int i = 0; i < repeat.value(); i++) {
-        if (verbose.count() >= 2) // verbosity level 2+
-            cout << "Starting timer: " << i << "/" << repeat.value() << "..." << endl;
+    chrono::duration<double> dur(config.delay);
+    for (int i = 0; i < config.repeat; i++) {
+        if (config.verbose >= 2) // verbosity level 2+
+            cout << "Starting timer: " << i << "/" << config.repeat << "..." << endl;
 
         this_thread::sleep_for(dur);
 
-        cout << message.value() << endl;
+        cout << config.message << endl;
     }
 }
@@ -0,0 +1,133 @@
+//
+//  abbrev.cpp
+//  Longname abbreviation tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+// Parser of `tokens`, accepting abbreviations unless `exact`
+struct Abbrev {
+    test::Argv argv;
+    clip::Parser parser;
+
+    Abbrev(initializer_list<const char *> tokens, bool exact = false) :
+        argv([&] {
+            test::Argv argv;
+            for (const char *token : tokens)
+                argv.push(token);
+            return argv;
+        }()),
+        parser(argv.argc(), argv.argv(), clip::App("test").version("1.0")) {
+        parser.abbreviate(!exact);
+        parser.add(clip::Flag("verbose").shortname('v'));
+        parser.add(clip::Opt<int>("number"));
+        parser.add(clip::Opt<string>("col"));
+        parser.add(clip::Opt<string>("color"));
+        parser.add(clip::Opt<string>("column"));
+        parser.command("run", "Run it.", [](clip::Parser &run) {
+            run.add(clip::Flag("dry-run"));
+            run.add(clip::Flag("debug"));
+        });
+    }
+
+    // Error from parsing (empty on success)
+    string parse() {
+        auto status = this->parser.tryParse();
+        return status ? string() : status.error().message;
+    }
+};
+
+void testUnique() {
+    // Unique prefixes resolve to their longname, with or without an attached value
+    Abbrev abbrev({"--verb", "--verbos", "--num", "3", "--colo=red", "--colu=2", "run"});
+    CHECK(abbrev.parse().empty());
+    CHECK(abbrev.parser.getFlag("verbose").count() == 2);
+    CHECK(abbrev.parser.getOpt<int>("number").value() == 3);
+    CHECK(abbrev.parser.getOpt<string>("color").value() == "red");
+    CHECK(abbrev.parser.getOpt<string>("column").value() == "2");
+    // ... as do those of automatic flags
+    Abbrev help({"--he"});
+    CHECK(help.parse() == "help requested");
+}
+
+void testExact() {
+    // Exact longnames win over longer ones they prefix
+    Abbrev abbrev({"--col", "x", "--color=y", "run"});
+    CHECK(abbrev.parse().empty());
+    CHECK(abbrev.parser.getOpt<string>("col").value() == "x");
+    CHECK(abbrev.parser.getOpt<string>("color").value() == "y");
+}
+
+void testAmbiguous() {
+    // Prefixes of several longnames are rejected, listing every candidate
+    Abbrev ver({"--ver", "run"});
+    CHECK(ver.parse() == "ambiguous option: `--ver` (could be `--verbose`, `--version`)");
+    Abbrev co({"--co=x", "run"});
+    CHECK(co.parse() == "ambiguous option: `--co` (could be `--col`, `--color`, `--column`)");
+    // ... and prefixes of none are unknown
+    Abbrev none({"--verbs", "run"});
+    CHECK(none.parse() == "illegal option: `--verbs`");
+}
+
+void testCommands() {
+    // Subcommands accept abbreviations of their own longnames likewise
+    Abbrev abbrev({"run", "--dr"});
+    CHECK(abbrev.parse().empty());
+    CHECK(abbrev.parser.command() && abbrev.parser.command()->getFlag("dry-run").count() == 1);
+    Abbrev ambiguous({"run", "--d"});
+    CHECK(ambiguous.parse() == "ambiguous option: `--d` (could be `--debug`, `--dry-run`)");
+}
+
+void testDisabled() {
+    // Abbreviations are rejected unless enabled
+    Abbrev abbrev({"--verb", "run"}, true);
+    CHECK(abbrev.parse() == "illegal option: `--verb`");
+    Abbrev run({"run", "--dr"}, true);
+    CHECK(run.parse() == "illegal option: `--dr`");
+    Abbrev exact({"--verbose", "run"}, true);
+    CHECK(exact.parse().empty());
+}
+
+void testMany() {
+    // Prefixes are indexed (beyond a linear scan), and again once abbreviations are toggled
+    clip::Parser parser(clip::App("test"));
+    parser.abbreviate(true);
+    for (char c = 'a'; c <= 't'; c++)
+        parser.add(clip::Flag(("key-" + string(1, c) + "-flag").data()));
+    parser.add(clip::Opt<int>("other"));
+    auto parse = [&](vector<string> tokens) {
+        clip::RangeSource source(tokens.begin(), tokens.end());
+        auto status = parser.tryParse(source);
+        return status ? string() : status.error().message;
+    };
+    CHECK(parse({"--key-c", "--key-t-", "--ot=1"}).empty());
+    CHECK(parser.getFlag("key-c-flag").count() == 1);
+    CHECK(parser.getFlag("key-t-flag").count() == 1);
+    CHECK(parser.getOpt<int>("other").value() == 1);
+    CHECK(parse({"--key-"}).starts_with("ambiguous option: `--key-` (could be `--key-a-flag`, "));
+    CHECK(parse({"--key-x"}) == "illegal option: `--key-x`");
+    parser.abbreviate(false);
+    CHECK(parse({"--key-c"}) == "illegal option: `--key-c`");
+    parser.abbreviate(true);
+    CHECK(parse({"--key-c"}).empty());
+}
+
+} // namespace
+
+int main() {
+    return test::run(testUnique, testExact, testAmbiguous, testCommands, testDisabled, testMany);
+}
@@ -0,0 +1,375 @@
+//
+//  alloc.cpp
+//  Allocation budget tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+// NOTE: budgets are exact counts, as allocated by GCC 12 with libstdc++; other standard libraries
+//       grow their containers differently, and will need their own budgets.
+
+namespace {
+
+enum class Level { Low, Medium, High };
+
+constexpr auto LEVELS = clip::choices([] {
+    return std::array{
+        clip::Choice{"low", Level::Low},
+        clip::Choice{"medium", Level::Medium},
+        clip::Choice{"high", Level::High},
+    };
+});
+
+} // namespace
+
+template <>
+struct clip::ValueTraits<Level> : clip::ChoiceTraits<LEVELS> {};
+
+namespace {
+
+vector<string> names(const char *prefix, size_t n) {
+    vector<string> v;
+    for (size_t i = 0; i < n; i++)
+        v.push_back(prefix + to_string(i));
+    return v;
+}
+
+void testHooks() {
+    // Every replaceable form of `operator new` is counted
+    BUDGET("new[]", 1, ::operator delete[](::operator new[](8)));
+    BUDGET("new(nothrow)", 1, ::operator delete(::operator new(8, nothrow), nothrow));
+    BUDGET("new[](nothrow)", 1, ::operator delete[](::operator new[](8, nothrow), nothrow));
+    BUDGET("new(align)", 1, ::operator delete(::operator new(8, align_val_t{64}), align_val_t{64}));
+    BUDGET("new[](align, nothrow)", 1, {
+        void *p = ::operator new[](8, align_val_t{64}, nothrow);
+        ::operator delete[](p, align_val_t{64}, nothrow);
+    });
+    // ... including those made within the standard library (a temporary buffer, here)
+    vector<int> v(100);
+    BUDGET("stable_sort", 1, stable_sort(v.begin(), v.end()));
+}
+
+void testAdd() {
+    // Registration grows its storage geometrically, never per param, except that copied params
+    // allocate strings too long to store inline once (before they are copied into the arena)
+    const char *help = "Sample integer, in any base.";
+    struct {
+        size_t n;
+        size_t budget;
+        size_t borrowing;
+    } cases[] = {{10, 28, 18}, {100, 133, 32}, {1000, 1047, 47}, {10000, 10065, 65}};
+    for (auto [n, budget, borrowing] : cases) {
+        const auto opts = names("opt", n);
+        test::Argv argv;
+        clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+        BUDGET("add/opt", budget, {
+            for (const auto &name : opts)
+                parser.add(clip::Opt<int>(name.data()).help(help));
+        });
+        clip::Parser borrowed(argv.argc(), argv.argv(), clip::App("test"));
+        // ... which borrowed params never do
+        BUDGET("add/borrow", borrowing, {
+            for (const auto &name : opts)
+                borrowed.add(clip::Opt<int>(name.data(), clip::borrowed).help(help));
+        });
+    }
+}
+
+void testBorrow() {
+    // Borrowed params point at the caller's strings, even once added
+    const string name = "a-sufficiently-long-param-name";
+    const string help = "A help string long enough to be allocated if copied.";
+    test::Argv argv;
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    auto opt = parser.add(clip::Opt<int>(name.data(), clip::borrowed).help(help.data()));
+    CHECK(opt->borrow());
+    CHECK(opt->name() == name.data());
+    CHECK(opt->longname() == name.data());
+    CHECK(opt->help() == help.data());
+    // Copied params own their strings
+    auto copied = parser.add(clip::Flag("flag").help(help.data()));
+    CHECK(!copied->borrow());
+    CHECK(copied->help() != help.data());
+    CHECK(copied->help() == help);
+}
+
+void testParseLong() {
+    // Parsing 10k long options performs no allocations after `freeze`
+    constexpr size_t n = 10000;
+    const auto opts = names("opt", n);
+    test::Argv joined, split;
+    for (size_t i = 0; i < n; i++) {
+        joined.push("--" + opts[i] + "=" + to_string(i));
+        split.push("--" + opts[i]).push(to_string(i));
+    }
+    for (test::Argv *argv : {&joined, &split}) {
+        clip::Parser parser(argv->argc(), argv->argv(), clip::App("test"));
+        for (const auto &name : opts)
+            parser.add(clip::Opt<int>(name.data()));
+        parser.freeze();
+        BUDGET(argv == &joined ? "parse/long=" : "parse/long", 0, parser.parse());
+        CHECK(parser.getOpt<int>("opt0").value() == 0);
+        CHECK(parser.getOpt<int>("opt9999").value() == 9999);
+    }
+}
+
+void testParseMixed() {
+    // Clusters, attached values, flags and positionals perform no allocations after `freeze`
+    test::Argv argv;
+    for (const char *token :
+         {"1", "-abc", "-n7", "-n", "7", "--flag", "-s=hello", "--str", "x", "2"})
+        argv.push(token);
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    parser.add(clip::Flag("alpha").shortname('a'));
+    parser.add(clip::Flag("bravo").shortname('b'));
+    parser.add(clip::Flag("charlie").shortname('c'));
+    parser.add(clip::Flag("flag"));
+    parser.add(clip::Opt<int>("num").shortname('n'));
+    parser.add(clip::Opt<string>("str").shortname('s'));
+    parser.add(clip::Arg<int>("first"));
+    parser.add(clip::Arg<int>("second"));
+    parser.freeze();
+    BUDGET("parse/mixed", 0, parser.parse());
+    CHECK(parser.getFlag("bravo").count() == 1);
+    CHECK(parser.getOpt<int>("num").value() == 7);
+    CHECK(parser.getOpt<string>("str").value() == "x");
+    CHECK(parser.getArg<int>("second").value() == 2);
+}
+
+void testParseResult() {
+    // Parsing into a separate result performs no allocations, even when reused
+    constexpr size_t n = 1000;
+    const auto opts = names("opt", n);
+    test::Argv argv;
+    for (size_t i = 0; i < n; i++)
+        argv.push("--" + opts[i] + "=" + to_string(i));
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    for (const auto &name : opts)
+        parser.add(clip::Opt<int>(name.data()));
+    parser.freeze();
+    clip::Result result(parser);
+    for (const char *name : {"parse/result", "parse/reuse"}) {
+        BUDGET(name, 0, {
+            result.reset();
+            clip::ArgvSource source(argv.argc() - 1, argv.argv() + 1);
+            CHECK(parser.tryParse(source, result));
+        });
+        CHECK(result.value<int>("opt999") == 999);
+        CHECK(result.count("opt999") == 1);
+    }
+}
+
+void testParseChoice() {
+    // Choices are resolved without allocating
+    constexpr size_t n = 1000;
+    test::Argv argv;
+    for (size_t i = 0; i < n; i++)
+        argv.push("--level=" + string(LEVELS.names()[i % LEVELS.size()]));
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    parser.add(clip::Opt<Level>("level"));
+    parser.freeze();
+    BUDGET("parse/choice", 0, parser.parse());
+    CHECK(parser.getOpt<Level>("level").value() == Level::Low);
+}
+
+void testConstraints() {
+    // Checking thousands of rules performs no allocations
+    constexpr size_t n = 1000;
+    const auto opts = names("opt", n);
+    const auto flags = names("flag", n);
+    test::Argv argv;
+    for (size_t i = 0; i < n; i++)
+        argv.push("--" + opts[i] + "=" + to_string(i));
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    for (size_t i = 0; i < n; i++) {
+        parser.add(clip::Opt<int>(opts[i].data()).required(true).range(0, int(n)));
+        parser.add(clip::Flag(flags[i].data()));
+        parser.conflicts(opts[i].data(), flags[i].data());
+        parser.needs(opts[i].data(), opts[(i + 1) % n].data());
+    }
+    parser.anyOf({"opt0", "flag0"});
+    parser.oneOf({"flag1", "opt1"});
+    parser.freeze();
+    clip::Result result(parser);
+    BUDGET("parse/constraints", 0, {
+        clip::ArgvSource source(argv.argc() - 1, argv.argv() + 1);
+        CHECK(parser.tryParse(source, result));
+    });
+
+    // Each rule reports its own error
+    auto fail = [](vector<string> tokens) {
+        test::Argv argv;
+        for (auto &token : tokens)
+            argv.push(token);
+        clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+        parser.add(clip::Opt<int>("num").range(1, 9));
+        parser.add(clip::Opt<int>("req").required(true));
+        parser.add(clip::Flag("a").shortname('a'));
+        parser.add(clip::Flag("b").shortname('b'));
+        parser.add(clip::Flag("c").shortname('c'));
+        parser.add(clip::Flag("d").shortname('d'));
+        parser.conflicts("a", "b").needs("c", "a").anyOf({"a", "d"}).oneOf({"c", "d"});
+        clip::ArgvSource source(argv.argc() - 1, argv.argv() + 1);
+        auto status = parser.tryParse(source);
+        return status ? string() : status.error().message;
+    };
+    CHECK(fail({"--req=1", "-ad"}).empty());
+    CHECK(fail({"--req=1", "-d", "--num=9"}).empty());
+    CHECK(fail({"-a"}) == "missing required option: `--req`");
+    CHECK(fail({"--req=1", "-a", "--num=10"}) == "value out of range for `--num`");
+    CHECK(fail({"--req=1", "-ab"}) == "`--a` cannot be used with `--b`");
+    CHECK(fail({"--req=1", "-cd"}) == "`--c` requires `--a`");
+    CHECK(fail({"--req=1"}) == "one of `--a`, `--d` is required");
+    CHECK(fail({"--req=1", "-acd"}) == "exactly one of `--c`, `--d` is required");
+}
+
+void testGet() {
+    // Looking up params performs no allocations
+    constexpr size_t n = 1000;
+    const auto opts = names("opt", n);
+    const auto args = names("arg", n);
+    test::Argv argv;
+    for (size_t i = 0; i < n; i++)
+        argv.push(to_string(i));
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    parser.add(clip::Flag("flag"));
+    for (size_t i = 0; i < n; i++)
+        parser.add(clip::Opt<int>(opts[i].data()).value(int(i)));
+    for (const auto &name : args)
+        parser.add(clip::Arg<int>(name.data()));
+    parser.parse();
+    size_t sum = 0;
+    BUDGET("get/opt", 0, {
+        for (const auto &name : opts)
+            sum += parser.getOpt<int>(name.data()).value();
+    });
+    BUDGET("get/arg", 0, {
+        for (const auto &name : args)
+            sum += parser.getArg<int>(name.data()).value();
+    });
+    BUDGET("get/flag", 0, sum += parser.getFlag("flag").count());
+    CHECK(sum == n * (n - 1));
+}
+
+void testBind() {
+    // Handles and bound targets are read without lookup or allocation
+    test::Argv argv;
+    for (const char *token : {"-vv", "--num=7", "--str", "hello", "3"})
+        argv.push(token);
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    struct {
+        unsigned int verbose;
+        int num;
+        string str;
+        int arg;
+        int unset;
+    } config{};
+    auto verbose = parser.add(clip::Flag("verbose").shortname('v').bind(&config.verbose));
+    auto num = parser.add(clip::Opt<int>("num").bind(&config.num));
+    auto str = parser.add(clip::Opt<string>("str").bind(&config.str));
+    auto arg = parser.add(clip::Arg<int>("arg").bind(&config.arg));
+    parser.add(clip::Opt<int>("unset").value(5).bind(&config.unset));
+    parser.parse();
+    size_t sum = 0;
+    BUDGET("get/handle", 0, {
+        sum = verbose->count() + num->value() + str->value().size() + (*arg).value();
+    });
+    CHECK(sum == 2 + 7 + 5 + 3);
+    CHECK(&*num == &parser.getOpt<int>("num"));
+    CHECK(config.verbose == 2);
+    CHECK(config.num == 7);
+    CHECK(config.str == "hello");
+    CHECK(config.arg == 3);
+    CHECK(config.unset == 5);
+}
+
+void testChain() {
+    // Adds chain through handles, each handle referring to the param just added
+    test::Argv argv;
+    argv.push("-v").push("--num=2").push("3");
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    auto arg = parser.add(clip::Flag("verbose").shortname('v'))
+                   .add(clip::Opt<int>("num"))
+                   .add(clip::Arg<int>("arg"));
+    parser.parse();
+    CHECK(parser.getFlag("verbose").count() == 1);
+    CHECK(parser.getOpt<int>("num").value() == 2);
+    CHECK(&*arg == &parser.getArg<int>("arg"));
+    CHECK(arg->value() == 3);
+}
+
+void testDuplicate() {
+    // Params that collide with an earlier name or longname are rejected when added (rather than
+    // ignored, keeping the earlier param)
+    auto rejected = [](auto add) {
+        try {
+            add();
+        } catch (const std::invalid_argument &) {
+            return true;
+        }
+        return false;
+    };
+    test::Argv argv;
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    auto num = parser.add(clip::Opt<int>("num").value(1));
+    CHECK(rejected([&] { parser.add(clip::Opt<int>("num")); }));
+    CHECK(rejected([&] { parser.add(clip::Arg<int>("num")); }));
+    CHECK(rejected([&] { parser.add(clip::Flag("other").longname("num")); }));
+    // ... so every handle refers to a param that survives `freeze`
+    parser.add(clip::Flag("help").longname("assist"));
+    parser.freeze();
+    CHECK(&*num == &parser.getOpt<int>("num"));
+    CHECK(num->value() == 1);
+}
+
+void testHelp() {
+    // Help and usage are each rendered into a single buffer
+    for (size_t n : {10, 1000}) {
+        const auto opts = names("opt", n);
+        test::Argv argv;
+        clip::Parser parser(argv.argc(), argv.argv(), clip::App("test").version("1.0"));
+        for (const auto &name : opts)
+            parser.add(clip::Opt<int>(name.data()).help("Sample integer."));
+        parser.add(clip::Arg<int>("arg").help("Sample positional."));
+        parser.freeze();
+        string help, usage;
+        BUDGET("help", 1, help = clip::detail::Formatters::help(parser));
+        BUDGET("usage", 1, usage = clip::detail::Formatters::usage(parser));
+        CHECK(help.find("--opt0") != string::npos);
+        CHECK(usage.find("<ARGS>") != string::npos);
+    }
+}
+
+} // namespace
+
+int main() {
+    return test::run(testHooks,
+                     testAdd,
+                     testBorrow,
+                     testParseLong,
+                     testParseMixed,
+                     testParseResult,
+                     testParseChoice,
+                     testConstraints,
+                     testGet,
+                     testBind,
+                     testChain,
+                     testDuplicate,
+                     testHelp);
+}
@@ -0,0 +1,118 @@
+//
+//  command.cpp
+//  Subcommand tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <initializer_list>
+#include <string>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+// Parser of `tool` with subcommands `run` (flags only), `add` (a required positional) and `echo`
+// (a string positional)
+struct Tool {
+    test::Argv argv;
+    clip::Parser parser;
+    int builds = 0;
+
+    Tool(initializer_list<const char *> tokens) :
+        argv([&] {
+            test::Argv argv("tool");
+            for (const char *token : tokens)
+                argv.push(token);
+            return argv;
+        }()),
+        parser(argv.argc(), argv.argv(), clip::App("tool")) {
+        parser.add(clip::Flag("verbose").shortname('v'));
+        parser.add(clip::Opt<clip::Set<int>>("set").shortname('s'));
+        parser.command("run", "Run it.", [this](clip::Parser &run) {
+            builds++;
+            run.add(clip::Flag("fast").shortname('f'));
+        });
+        parser.command("add", "Add one.", [this](clip::Parser &add) {
+            builds++;
+            add.add(clip::Arg<int>("item"));
+        });
+        parser.command("echo", "Echo one.", [this](clip::Parser &echo) {
+            builds++;
+            echo.add(clip::Arg<string>("text"));
+        });
+    }
+
+    // Error from parsing (empty on success)
+    string parse() {
+        auto status = this->parser.tryParse();
+        return status ? string() : status.error().message;
+    }
+};
+
+void testSelect() {
+    // Only the selected subcommand is built, then parses the remaining arguments
+    Tool tool({"-v", "run", "-f"});
+    CHECK(tool.parse().empty());
+    CHECK(tool.builds == 1);
+    CHECK(tool.parser.getFlag("verbose").count() == 1);
+    clip::Parser *run = tool.parser.command();
+    CHECK(run);
+    CHECK(run && run->getFlag("fast").count() == 1);
+}
+
+void testBare() {
+    // Subcommands need no arguments of their own, whether or not preceded by options
+    Tool run({"run"});
+    CHECK(run.parse().empty());
+    Tool verbose({"-v", "run"});
+    CHECK(verbose.parse().empty());
+    // ... though their own positionals are still required
+    Tool add({"add"});
+    CHECK(add.parse() == "missing arguments");
+}
+
+void testParent() {
+    // Options before the subcommand are finished like any other parse
+    Tool tool({"-s3", "-s1", "-s3", "run"});
+    CHECK(tool.parse().empty());
+    CHECK(tool.parser.getOpt<clip::Set<int>>("set").value() == clip::Set<int>({1, 3}));
+}
+
+void testErrors() {
+    // A missing or unknown subcommand is reported by the parent
+    Tool missing({"-v"});
+    CHECK(missing.parse() == "missing command");
+    Tool unknown({"walk"});
+    CHECK(unknown.parse() == "unknown command: `walk`");
+    Tool empty({});
+    CHECK(empty.parse() == "no arguments supplied");
+}
+
+void testTerminator() {
+    // Subcommands are not selected after `--`
+    Tool tool({"--", "run"});
+    CHECK(tool.parse() == "unexpected token: `run`");
+    CHECK(tool.builds == 0);
+    // ... and response files after a subcommand's own `--` are taken literally
+    test::File file("command.rsp", "-v");
+    string at = "@" + file.path();
+    Tool echo({"echo", "--", at.data()});
+    CHECK(echo.parse().empty());
+    clip::Parser *command = echo.parser.command();
+    CHECK(command && command->getArg<string>("text").value() == at);
+    Tool expanded({"echo", at.data(), "x"});
+    CHECK(expanded.parse() == "illegal option: `-v`");
+}
+
+} // namespace
+
+int main() {
+    return test::run(testSelect, testBare, testParent, testErrors, testTerminator);
+}
@@ -0,0 +1,133 @@
+//
+//  complete.cpp
+//  Shell completion tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <array>
+#include <initializer_list>
+#include <string>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+enum class Level { Low, Medium, High };
+
+constexpr auto LEVELS = clip::choices([] {
+    return std::array{
+        clip::Choice{"low", Level::Low},
+        clip::Choice{"medium", Level::Medium},
+        clip::Choice{"high", Level::High},
+    };
+});
+
+} // namespace
+
+template <>
+struct clip::ValueTraits<Level> : clip::ChoiceTraits<LEVELS> {};
+
+namespace {
+
+// Output of `tool --clip-complete` (or `--clip-complete-script`) with `tokens`, or its error
+string complete(initializer_list<const char *> tokens, const char *mode = "--clip-complete") {
+    test::Argv argv("tool");
+    argv.push(mode);
+    for (const char *token : tokens)
+        argv.push(token);
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("tool").version("1.0"));
+    parser.add(clip::Flag("verbose").shortname('v'));
+    parser.add(clip::Opt<Level>("level").shortname('l'));
+    parser.add(clip::Opt<int>("limit"));
+    parser.command("run", "Run it.", [](clip::Parser &run) {
+        run.add(clip::Flag("fast").shortname('f'));
+        run.add(clip::Arg<Level>("level"));
+    });
+    parser.command("rest", "Rest a while.", [](clip::Parser &) {});
+    auto status = parser.tryParse();
+    if (status)
+        return "(parsed)";
+    if (status.error().code != clip::Errc::Complete)
+        return "error: " + status.error().message;
+    CHECK(status.error().status() == 0);
+    return status.error().message;
+}
+
+void testLongnames() {
+    // Longnames are completed from their prefix, in sorted order
+    CHECK(complete({"1", "tool", "--l"}) == "--level\n--limit\n");
+    CHECK(complete({"1", "tool", "--ve"}) == "--verbose\n--version\n");
+    CHECK(complete({"1", "tool", "--"}) == "--help\n--level\n--limit\n--verbose\n--version\n");
+    CHECK(complete({"1", "tool", "--x"}).empty());
+    // ... and together with shortnames from a bare dash
+    CHECK(complete({"1", "tool", "-"}) ==
+          "-V\n-h\n-l\n-v\n--help\n--level\n--limit\n--verbose\n--version\n");
+}
+
+void testValues() {
+    // Values are completed from their choices, whether separate or attached
+    CHECK(complete({"2", "tool", "--level", ""}) == "low\nmedium\nhigh\n");
+    CHECK(complete({"2", "tool", "-l", "m"}) == "medium\n");
+    CHECK(complete({"2", "tool", "-vl", "h"}) == "high\n");
+    CHECK(complete({"1", "tool", "--level=l"}) == "--level=low\n");
+    // ... and otherwise left to the shell
+    CHECK(complete({"2", "tool", "--limit", ""}).empty());
+    CHECK(complete({"1", "tool", "--limit="}).empty());
+    // Attached values are skipped over
+    CHECK(complete({"2", "tool", "-lhigh", "--ve"}) == "--verbose\n--version\n");
+    CHECK(complete({"3", "tool", "--level", "low", "r"}) == "rest\nrun\n");
+}
+
+void testCommands() {
+    // Commands are completed in place of the first positional
+    CHECK(complete({"1", "tool", ""}) == "rest\nrun\n");
+    CHECK(complete({"2", "tool", "-v", "ru"}) == "run\n");
+    // ... after which their own params are completed
+    CHECK(complete({"2", "tool", "run", "--"}) == "--fast\n--help\n--version\n");
+    CHECK(complete({"2", "tool", "run", "-"}) == "-V\n-f\n-h\n--fast\n--help\n--version\n");
+    CHECK(complete({"2", "tool", "run", "m"}) == "medium\n");
+    CHECK(complete({"4", "tool", "run", "-f", "--", "-"}).empty());
+    CHECK(complete({"3", "tool", "run", "--", "h"}) == "high\n");
+    CHECK(complete({"2", "tool", "rest", ""}).empty());
+}
+
+void testTerminator() {
+    // Options are not completed after `--`
+    CHECK(complete({"2", "tool", "--", "--"}).empty());
+    CHECK(complete({"2", "tool", "--", "-"}).empty());
+}
+
+void testScripts() {
+    // Scripts are printed for each supported shell, calling back into the app
+    for (const char *shell : {"bash", "zsh", "fish"}) {
+        string script = complete({shell}, "--clip-complete-script");
+        CHECK(script.find("--clip-complete ") != string::npos);
+        CHECK(script.find("_clip_tool") != string::npos);
+    }
+    string bash = complete({"bash"}, "--clip-complete-script");
+    CHECK(bash.find("complete -o default -F _clip_tool tool\n") != string::npos);
+}
+
+void testErrors() {
+    // Malformed requests are reported as invalid values
+    CHECK(complete({"x", "tool"}) == "error: invalid value for `--clip-complete=x`");
+    CHECK(complete({}) == "error: invalid value for `--clip-complete=`");
+    CHECK(complete({"tcsh"}, "--clip-complete-script") ==
+          "error: invalid value for `--clip-complete-script=tcsh`");
+    // Words beyond those supplied complete as empty
+    CHECK(complete({"5", "tool", "-v"}) == "rest\nrun\n");
+}
+
+} // namespace
+
+int main() {
+    return test::run(
+        testLongnames, testValues, testCommands, testTerminator, testScripts, testErrors);
+}
@@ -0,0 +1,135 @@
+//
+//  config.cpp
+//  Config file tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <cstdlib>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+using Ints = vector<int>;
+
+using test::File;
+
+// Parser of `tokens`, layered over `configs`
+struct Config {
+    test::Argv argv;
+    clip::Parser parser;
+
+    Config(initializer_list<const char *> tokens, initializer_list<const File *> configs) :
+        argv([&] {
+            test::Argv argv;
+            for (const char *token : tokens)
+                argv.push(token);
+            return argv;
+        }()),
+        parser(argv.argc(), argv.argv(), clip::App("test")) {
+        parser.add(clip::Opt<int>("num").env("CLIP_CONFIG_NUM").value(1));
+        parser.add(clip::Opt<int>("other").value(2));
+        parser.add(clip::Opt<string>("log-file").value("-"));
+        parser.add(clip::Opt<Ints>("list").value({1, 2}));
+        parser.add(clip::Flag("verbose").shortname('v'));
+        for (const File *config : configs)
+            parser.config(config->path().data());
+    }
+
+    // Error from parsing (empty on success)
+    string parse() {
+        auto status = this->parser.tryParse();
+        return status ? string() : status.error().message;
+    }
+};
+
+void testEntries() {
+    // Keys are matched against longnames, prefixed by their section
+    File file("entries.toml", "# comment\n"
+                              "num = 3 # inline\n"
+                              "list = [3, 4]\n"
+                              "verbose = 2\n"
+                              "[log]\n"
+                              "file = \"out\\tlog\"\n");
+    Config config({"--other", "4"}, {&file});
+    CHECK(config.parse().empty());
+    CHECK(config.parser.getOpt<int>("num").value() == 3);
+    CHECK(config.parser.getOpt<Ints>("list").value() == Ints({3, 4}));
+    CHECK(config.parser.getFlag("verbose").count() == 2);
+    CHECK(config.parser.getOpt<string>("log-file").value() == "out\tlog");
+}
+
+void testPrecedence() {
+    // Values are taken from defaults, then config files (later first), the environment and the
+    // command line
+    File lower("lower.ini", "num = 3\nother = 3\nlog-file = lower\nlist = 3\n");
+    File upper("upper.ini", "num = 4\nother = 4\n");
+    setenv("CLIP_CONFIG_NUM", "5", 1);
+    Config config({"--other", "6"}, {&lower, &upper});
+    CHECK(config.parse().empty());
+    unsetenv("CLIP_CONFIG_NUM");
+    CHECK(config.parser.getOpt<int>("num").value() == 5);
+    CHECK(config.parser.getOpt<int>("other").value() == 6);
+    CHECK(config.parser.getOpt<string>("log-file").value() == "lower");
+    // ... with repeated lines of one file appending, but replacing the default
+    CHECK(config.parser.getOpt<Ints>("list").value() == Ints({3}));
+    File repeated("repeated.ini", "list = 3\nlist = [4, 5]\n");
+    Config other({"-v"}, {&repeated});
+    CHECK(other.parse().empty());
+    CHECK(other.parser.getOpt<Ints>("list").value() == Ints({3, 4, 5}));
+}
+
+void testFlags() {
+    // Flags are set by a boolean or a count, and left unset by `false`
+    File on("on.ini", "verbose = true\n");
+    File off("off.ini", "verbose = false\n");
+    Config set({"--num", "2"}, {&on});
+    CHECK(set.parse().empty());
+    CHECK(set.parser.getFlag("verbose").count() == 1);
+    Config unset({"--num", "2"}, {&off});
+    CHECK(unset.parse().empty());
+    CHECK(unset.parser.getFlag("verbose").count() == 0);
+}
+
+void testMissing() {
+    // Missing files are skipped
+    Config config({"--num", "2"}, {});
+    config.parser.config("/nonexistent/clip.ini");
+    CHECK(config.parse().empty());
+    CHECK(config.parser.getOpt<int>("other").value() == 2);
+}
+
+void testErrors() {
+    // Errors are reported at their line
+    auto fail = [](const string &name, const string &text) {
+        File file(name, text);
+        Config config({"--num", "2"}, {&file});
+        string error = config.parse();
+        return error.starts_with(file.path()) ? error.substr(file.path().size()) : error;
+    };
+    CHECK(fail("unknown.ini", "num = 3\n\nnope = 1\n") == ":3: unknown key: `nope`");
+    CHECK(fail("invalid.ini", "# ok\nother = x\n") == ":2: invalid value for `other = x`");
+    CHECK(fail("flag.ini", "verbose = yes\n") == ":1: invalid value for `verbose = yes`");
+    CHECK(fail("string.ini", "num = 3\n\n\nlog-file = \"out\n") == ":4: unterminated string");
+    CHECK(fail("rest.ini", "log-file = \"out\" log\n") == ":1: unexpected `log`");
+    CHECK(fail("section.ini", "[log\n") == ":1: unterminated section");
+    CHECK(fail("array.ini", "list = [1, 2\n") == ":1: unterminated array");
+    CHECK(fail("entry.ini", "num = 3\nnum\n") == ":2: expected `key = value`");
+    CHECK(fail("help.ini", "help = true\n") == ":1: unknown key: `help`");
+}
+
+} // namespace
+
+int main() {
+    return test::run(testEntries, testPrecedence, testFlags, testMissing, testErrors);
+}
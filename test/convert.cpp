@@ -0,0 +1,180 @@
+//
+//  convert.cpp
+//  Value conversion tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+// Value converted from `s` (or none, if invalid)
+template <typename T>
+optional<T> parse(string_view s) {
+    T value{};
+    if (!clip::convert(s, value))
+        return nullopt;
+    return value;
+}
+
+void testIntegers() {
+    // Integers accept a sign and a base prefix
+    CHECK(parse<int>("42") == 42);
+    CHECK(parse<int>("+42") == 42);
+    CHECK(parse<int>("-42") == -42);
+    CHECK(parse<int>("0x2a") == 42);
+    CHECK(parse<int>("0o52") == 42);
+    CHECK(parse<int>("0b101010") == 42);
+    CHECK(parse<int>("-0x2A") == -42);
+    // ... but nothing else
+    for (string_view s : {"", "-", "0x", "0xg", "4 2", "42 ", " 42", "1e3", "forty", "1.", ".5"})
+        CHECK(!parse<int>(s));
+}
+
+void testSuffixes() {
+    // `K` and `KiB` forms are powers of 1024, while `KB` forms are powers of 1000
+    CHECK(parse<long>("1K") == 1024);
+    CHECK(parse<long>("1Ki") == 1024);
+    CHECK(parse<long>("1KiB") == 1024);
+    CHECK(parse<long>("1KB") == 1000);
+    CHECK(parse<long>("2M") == 2 << 20);
+    CHECK(parse<long>("2MB") == 2000000);
+    CHECK(parse<long>("3G") == 3L << 30);
+    CHECK(parse<long>("1E") == 1L << 60);
+    CHECK(parse<long>("7B") == 7);
+    // ... and are case sensitive
+    for (string_view s : {"1k", "1kB", "1KIB", "1Kb", "1KBB", "1X", "K"})
+        CHECK(!parse<long>(s));
+}
+
+void testFractions() {
+    // Fractions are accepted only where the result is an exact integer
+    CHECK(parse<long>("1.5K") == 1536);
+    CHECK(parse<long>("1.5KB") == 1500);
+    CHECK(parse<long>("0.5K") == 512);
+    CHECK(parse<long>("2.0") == 2);
+    CHECK(parse<long>("-1.25K") == -1280);
+    CHECK(!parse<long>("1.5"));
+    CHECK(!parse<long>("1.0001K"));
+    // ... and must have digits after the point
+    CHECK(!parse<long>("1."));
+    CHECK(!parse<long>("1.K"));
+    CHECK(!parse<long>("-1."));
+}
+
+void testRanges() {
+    // Values must fit their type
+    CHECK(parse<int8_t>("127") == 127);
+    CHECK(parse<int8_t>("-128") == -128);
+    CHECK(parse<int8_t>("-0x80") == -128);
+    CHECK(!parse<int8_t>("128"));
+    CHECK(!parse<int8_t>("-129"));
+    CHECK(parse<uint8_t>("255") == 255);
+    CHECK(parse<uint8_t>("-0") == 0);
+    CHECK(!parse<uint8_t>("256"));
+    CHECK(!parse<uint8_t>("-1"));
+    CHECK(!parse<uint16_t>("64K"));
+    CHECK(parse<uint64_t>("18446744073709551615") == UINT64_MAX);
+    CHECK(parse<int64_t>("-9223372036854775808") == INT64_MIN);
+    // ... without overflowing along the way
+    CHECK(!parse<uint64_t>("18446744073709551616"));
+    CHECK(!parse<int64_t>("9223372036854775808"));
+    CHECK(!parse<uint64_t>("0x10000000000000000"));
+    CHECK(parse<uint64_t>("15E") == 15ULL << 60);
+    CHECK(!parse<uint64_t>("16E"));
+    CHECK(!parse<uint64_t>("18446744073709551615K"));
+    CHECK(!parse<uint64_t>("0.00000000000000000001E"));
+}
+
+void testFloats() {
+    // Floating point values accept anything `std::from_chars` does, and a leading `+`
+    CHECK(parse<double>("1.5") == 1.5);
+    CHECK(parse<double>("+1.5") == 1.5);
+    CHECK(parse<double>("-1e3") == -1000.0);
+    CHECK(parse<double>("1.") == 1.0);
+    CHECK(!parse<double>(""));
+    CHECK(!parse<double>("1.5x"));
+    CHECK(!parse<double>("1e999"));
+    // ... but only one sign
+    CHECK(!parse<double>("+-5"));
+    CHECK(!parse<double>("++5"));
+    CHECK(!parse<double>("-+5"));
+}
+
+void testDurations() {
+    using namespace chrono;
+    // Durations take a unit, or are in their own period
+    CHECK(parse<seconds>("90") == 90s);
+    CHECK(parse<seconds>("2m") == 120s);
+    CHECK(parse<seconds>("2min") == 120s);
+    CHECK(parse<seconds>("1.5h") == 5400s);
+    CHECK(parse<seconds>("-1d") == -86400s);
+    CHECK(parse<milliseconds>("250ms") == 250ms);
+    CHECK(parse<milliseconds>("1.5s") == 1500ms);
+    CHECK(parse<microseconds>("3us") == 3us);
+    CHECK(parse<microseconds>("3µs") == 3us);
+    CHECK(parse<nanoseconds>("1.000000001s") == 1000000001ns);
+    // ... which must be a whole number of ticks within range
+    CHECK(!parse<seconds>("250ms"));
+    CHECK(!parse<seconds>("1."));
+    CHECK(!parse<seconds>("1.s"));
+    CHECK(!parse<seconds>("1 s"));
+    CHECK(!parse<seconds>("1S"));
+    CHECK(!parse<nanoseconds>("1000000d"));
+    CHECK(!parse<duration<int8_t>>("128s"));
+}
+
+void testFractional() {
+    using namespace chrono;
+    using Seconds = duration<double>;
+    using Millis = duration<float, milli>;
+    using Hours = duration<double, ratio<3600>>;
+    // Floating point durations accept any fraction of a tick
+    CHECK(parse<Seconds>("250ms") == Seconds(0.25));
+    CHECK(parse<Seconds>("1.5") == Seconds(1.5));
+    CHECK(parse<Seconds>("-2m") == Seconds(-120));
+    CHECK(parse<Millis>("1.5us") == Millis(0.0015f));
+    // ... with the same syntax as integral ones
+    for (string_view s : {"", "1.", "+-1s", "1e3s", "1 s", "inf", "nan", "1S"})
+        CHECK(!parse<Seconds>(s));
+    CHECK(!parse<duration<float>>("1000000000000000000000000000000000000000d"));
+    // ... and may be held by options
+    test::Argv argv;
+    argv.push("--wait=1.5h");
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    parser.add(clip::Opt<Hours>("wait"));
+    parser.parse();
+    CHECK(parser.getOpt<Hours>("wait").value() == Hours(1.5));
+}
+
+void testStrings() {
+    // Strings must be non-empty
+    CHECK(parse<string>("x") == "x");
+    CHECK(!parse<string>(""));
+}
+
+} // namespace
+
+int main() {
+    return test::run(testIntegers,
+                     testSuffixes,
+                     testFractions,
+                     testRanges,
+                     testFloats,
+                     testDurations,
+                     testFractional,
+                     testStrings);
+}
@@ -0,0 +1,132 @@
+//
+//  env.cpp
+//  Environment variable tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <cstdlib>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+using Ints = vector<int>;
+
+// Parser of `tokens`, with options bound to explicit and derived variables
+struct Env {
+    test::Argv argv;
+    clip::Parser parser;
+
+    Env(initializer_list<const char *> tokens, const char *envargs = "CLIP_TEST_ARGS") :
+        argv([&] {
+            test::Argv argv;
+            for (const char *token : tokens)
+                argv.push(token);
+            return argv;
+        }()),
+        parser(argv.argc(), argv.argv(), clip::App("test").env("CLIP_TEST_").envargs(envargs)) {
+        parser.add(clip::Opt<int>("num").env("CLIP_NUM").value(1));
+        parser.add(clip::Opt<int>("dry-run").value(2));
+        parser.add(clip::Opt<Ints>("list").value({1, 2}));
+        parser.add(clip::Flag("verbose").env("CLIP_VERBOSE"));
+    }
+
+    // Error from parsing (empty on success)
+    string parse() {
+        auto status = this->parser.tryParse();
+        return status ? string() : status.error().message;
+    }
+};
+
+// Set `vars` for the duration of a test
+struct Vars {
+    vector<string> names;
+
+    Vars(initializer_list<pair<const char *, const char *>> vars) {
+        for (auto [name, value] : vars) {
+            setenv(name, value, 1);
+            this->names.emplace_back(name);
+        }
+    }
+
+    ~Vars() {
+        for (const auto &name : this->names)
+            unsetenv(name.data());
+    }
+};
+
+void testFallback() {
+    // Unmatched options fall back to explicit and derived variables
+    Vars vars({{"CLIP_NUM", "5"}, {"CLIP_TEST_DRY_RUN", "6"}, {"CLIP_VERBOSE", "1"}});
+    Env env({});
+    CHECK(env.parse().empty());
+    CHECK(env.parser.getOpt<int>("num").value() == 5);
+    CHECK(env.parser.getOpt<int>("dry-run").value() == 6);
+    CHECK(env.parser.getFlag("verbose").count() == 1);
+    // ... unless set explicitly, which derives no variable
+    Vars derived({{"CLIP_TEST_NUM", "7"}});
+    Env other({});
+    CHECK(other.parse().empty());
+    CHECK(other.parser.getOpt<int>("num").value() == 5);
+}
+
+void testPrecedence() {
+    // The command line takes precedence over the environment, which does over defaults
+    Vars vars({{"CLIP_NUM", "5"}, {"CLIP_TEST_DRY_RUN", "6"}});
+    Env env({"--num", "7"});
+    CHECK(env.parse().empty());
+    CHECK(env.parser.getOpt<int>("num").value() == 7);
+    CHECK(env.parser.getOpt<int>("dry-run").value() == 6);
+    CHECK(env.parser.getOpt<Ints>("list").value() == Ints({1, 2}));
+}
+
+void testFlags() {
+    // Flags are unset by empty, `0` or `false` values
+    for (const char *value : {"", "0", "false"}) {
+        Vars vars({{"CLIP_VERBOSE", value}});
+        Env env({"--num", "3"});
+        CHECK(env.parse().empty());
+        CHECK(env.parser.getFlag("verbose").count() == 0);
+    }
+}
+
+void testRepeated() {
+    // Variables replace the default of repeated options, rather than appending to it
+    Vars vars({{"CLIP_TEST_LIST", "3"}});
+    Env env({});
+    CHECK(env.parse().empty());
+    CHECK(env.parser.getOpt<Ints>("list").value() == Ints({3}));
+}
+
+void testArgs() {
+    // Arguments from the aggregate variable are parsed ahead of the command line
+    Vars vars({{"CLIP_TEST_ARGS", "--list 4  --num=8"}});
+    Env env({"--list", "5"});
+    CHECK(env.parse().empty());
+    CHECK(env.parser.getOpt<int>("num").value() == 8);
+    CHECK(env.parser.getOpt<Ints>("list").value() == Ints({4, 5}));
+}
+
+void testErrors() {
+    // Invalid values are reported with their variable
+    Vars vars({{"CLIP_NUM", "five"}});
+    Env env({});
+    CHECK(env.parse() == "invalid value for `$CLIP_NUM=five`");
+}
+
+} // namespace
+
+int main() {
+    return test::run(testFallback, testPrecedence, testFlags, testRepeated, testArgs, testErrors);
+}
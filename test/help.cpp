@@ -0,0 +1,145 @@
+//
+//  help.cpp
+//  Help rendering tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+enum class Level { Low, Medium, High };
+
+constexpr auto LEVELS = clip::choices([] {
+    return std::array{
+        clip::Choice{"low", Level::Low},
+        clip::Choice{"medium", Level::Medium},
+        clip::Choice{"high", Level::High},
+    };
+});
+
+} // namespace
+
+template <>
+struct clip::ValueTraits<Level> : clip::ChoiceTraits<LEVELS> {};
+
+namespace {
+
+// Help of a sample parser, as printed to a file with `COLUMNS=width`
+string help(size_t width) {
+    clip::Parser parser(clip::App("tool").version("1.0").about("Process input."));
+    parser.add(clip::Flag("verbose").shortname('v').help(
+        "Increase verbosity, which may be repeated for more detail."));
+    parser.add(
+        clip::Opt<int>("jobs").shortname('j').metavar("N").help("Run up to N jobs at once."));
+    parser.add(clip::Opt<Level>("level").help("Logging level."));
+    parser.add(clip::Arg<string>("input").help("File to read, or a dash for standard input."));
+    parser.command(
+        "run", "Run over the input, stopping at the first error.", [](clip::Parser &) {});
+    parser.freeze();
+
+    // Print to a file (rather than a terminal, whose own width would win)
+    test::File file("help.txt", "");
+    ::setenv("COLUMNS", to_string(width).data(), 1);
+    int fd = ::open(file.path().data(), O_WRONLY | O_TRUNC);
+    parser.printHelp(fd);
+    ::close(fd);
+    ::unsetenv("COLUMNS");
+    ifstream in(file.path());
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+constexpr const char *HEADER = "tool 1.0\n"
+                               "Process input.\n"
+                               "\n"
+                               "USAGE: \n"
+                               "\ttool [FLAGS] [OPTIONS] <ARGS> <COMMAND>\n"
+                               "\n";
+
+void testWide() {
+    // Names share one column, with help text on a single line
+    CHECK(help(200) == string(HEADER) +
+                           "FLAGS:\n"
+                           "\t-v, --verbose        "
+                           "Increase verbosity, which may be repeated for more detail.\n"
+                           "\t-h, --help           Print this message.\n"
+                           "\t-V, --version        Print version information.\n"
+                           "\n"
+                           "OPTIONS:\n"
+                           "\t-j, --jobs <N>       Run up to N jobs at once.\n"
+                           "\t    --level <LEVEL>  Logging level. [choices: low, medium, high]\n"
+                           "\n"
+                           "ARGS:\n"
+                           "\t<INPUT>              File to read, or a dash for standard input.\n"
+                           "\n"
+                           "COMMANDS:\n"
+                           "\trun                  "
+                           "Run over the input, stopping at the first error.\n"
+                           "\n");
+}
+
+void testNarrow() {
+    // Help text and choices wrap at spaces, continuing under the column
+    CHECK(help(60) == string(HEADER) +
+                          "FLAGS:\n"
+                          "\t-v, --verbose        Increase verbosity, which may\n"
+                          "\t                     be repeated for more detail.\n"
+                          "\t-h, --help           Print this message.\n"
+                          "\t-V, --version        Print version information.\n"
+                          "\n"
+                          "OPTIONS:\n"
+                          "\t-j, --jobs <N>       Run up to N jobs at once.\n"
+                          "\t    --level <LEVEL>  Logging level. [choices: low,\n"
+                          "\t                     medium, high]\n"
+                          "\n"
+                          "ARGS:\n"
+                          "\t<INPUT>              File to read, or a dash for\n"
+                          "\t                     standard input.\n"
+                          "\n"
+                          "COMMANDS:\n"
+                          "\trun                  Run over the input, stopping at\n"
+                          "\t                     the first error.\n"
+                          "\n");
+    // ... within the width
+    string out = help(60);
+    for (size_t start = 0, end; (end = out.find('\n', start)) != string::npos; start = end + 1) {
+        string line = out.substr(start, end - start);
+        size_t tabs = line.starts_with('\t') ? 7 : 0; // expanded to the first tab stop
+        CHECK(line.size() + tabs <= 60);
+    }
+}
+
+void testCramped() {
+    // Too narrow to wrap, the column shrinks and longer names overflow onto their own line
+    string out = help(40);
+    CHECK(out.find("\t-v, --verbose   Increase verbosity, which may be repeated for more "
+                   "detail.\n") != string::npos);
+    CHECK(out.find("\t    --level <LEVEL>\n"
+                   "\t                Logging level. [choices: low, medium, high]\n") !=
+          string::npos);
+    CHECK(out.find("\trun             Run over the input, stopping at the first error.\n") !=
+          string::npos);
+}
+
+} // namespace
+
+int main() {
+    return test::run(testWide, testNarrow, testCramped);
+}
@@ -0,0 +1,186 @@
+//
+//  hooks.h
+//  Hooks shared by the test and benchmark harnesses.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "clip/parser.h"
+
+// NOTE: the global allocation hooks below replace `operator new`/`operator delete`, so this header
+//       must be included by exactly one translation unit per binary.
+
+namespace hooks {
+
+// allocation counters (shared by every thread)
+inline std::atomic<std::size_t> allocs = 0;
+inline std::atomic<std::size_t> bytes = 0;
+
+// class Argv
+// Owns a synthetic `argv` array suitable for `clip::Parser`.
+class Argv final {
+private:
+    // impl members
+    std::vector<std::string> tokens;
+    std::vector<char *> ptrs;
+
+public:
+    // ctors
+    Argv(const char *prog = "clip") {
+        this->tokens.emplace_back(prog);
+    }
+
+    // builders
+    Argv &push(std::string token) {
+        this->tokens.push_back(std::move(token));
+        return *this;
+    }
+
+    // accessors
+    int argc() const {
+        return static_cast<int>(this->tokens.size());
+    }
+
+    char **argv() {
+        this->ptrs.clear();
+        for (auto &token : this->tokens)
+            this->ptrs.push_back(token.data());
+        this->ptrs.push_back(nullptr);
+        return this->ptrs.data();
+    }
+};
+
+// Allocate `n` bytes aligned to `align`, counting the allocation (null on failure)
+inline void *allocate(std::size_t n, std::size_t align) noexcept {
+    allocs.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(n, std::memory_order_relaxed);
+    // Both `malloc` and `aligned_alloc` are released through `free`
+    return align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__
+               ? std::malloc(n ? n : 1)
+               : std::aligned_alloc(align, (n ? n + align - 1 : align) / align * align);
+}
+
+// Allocate as above, throwing on failure
+inline void *allocateOrThrow(std::size_t n, std::size_t align) {
+    if (void *p = allocate(n, align))
+        return p;
+    throw std::bad_alloc();
+}
+
+} // namespace hooks
+
+// class clip::detail::Formatters
+// Renders help and usage through a parser's private formatters, so they can be measured directly.
+struct clip::detail::Formatters {
+    static std::string help(const clip::Parser &parser) {
+        return parser.help_s();
+    }
+
+    static std::string usage(const clip::Parser &parser) {
+        return parser.usage_s();
+    }
+};
+
+// global allocation hooks
+//
+// Every replaceable form is defined (plain, array, nothrow and aligned), so that allocations made
+// through any of them are counted and released through the matching `free`. Kept out of line so
+// that the compiler pairs each `delete` with its `new` rather than seeing `free` called on memory
+// from `operator new` (`-Wmismatched-new-delete`).
+[[gnu::noinline]] void *operator new(std::size_t n) {
+    return hooks::allocateOrThrow(n, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+[[gnu::noinline]] void *operator new[](std::size_t n) {
+    return hooks::allocateOrThrow(n, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+[[gnu::noinline]] void *operator new(std::size_t n, std::align_val_t align) {
+    return hooks::allocateOrThrow(n, static_cast<std::size_t>(align));
+}
+
+[[gnu::noinline]] void *operator new[](std::size_t n, std::align_val_t align) {
+    return hooks::allocateOrThrow(n, static_cast<std::size_t>(align));
+}
+
+[[gnu::noinline]] void *operator new(std::size_t n, const std::nothrow_t &) noexcept {
+    return hooks::allocate(n, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+[[gnu::noinline]] void *operator new[](std::size_t n, const std::nothrow_t &) noexcept {
+    return hooks::allocate(n, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+[[gnu::noinline]] void *operator new(std::size_t n,
+                                     std::align_val_t align,
+                                     const std::nothrow_t &) noexcept {
+    return hooks::allocate(n, static_cast<std::size_t>(align));
+}
+
+[[gnu::noinline]] void *operator new[](std::size_t n,
+                                       std::align_val_t align,
+                                       const std::nothrow_t &) noexcept {
+    return hooks::allocate(n, static_cast<std::size_t>(align));
+}
+
+[[gnu::noinline]] void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete[](void *p,
+                                         std::align_val_t,
+                                         const std::nothrow_t &) noexcept {
+    std::free(p);
+}
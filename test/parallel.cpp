@@ -0,0 +1,109 @@
+//
+//  parallel.cpp
+//  Parallel conversion tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+// Values parsed from `argv` with conversions spread across `threads`
+struct Parsed {
+    string error;
+    vector<long> ids;
+    vector<double> coords;
+    clip::Set<string> tags;
+    vector<int> points;
+    unsigned int verbose;
+};
+
+Parsed parse(test::Argv &argv, size_t threads) {
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    Parsed parsed{};
+    parser.add(clip::Opt<vector<long>>("id").shortname('i').bind(&parsed.ids));
+    parser.add(clip::Opt<vector<double>>("coord").shortname('c').nargs(3).bind(&parsed.coords));
+    parser.add(clip::Opt<clip::Set<string>>("tag").shortname('t').bind(&parsed.tags));
+    parser.add(clip::Flag("verbose").shortname('v').bind(&parsed.verbose));
+    parser.add(clip::Arg<vector<int>>("points").bind(&parsed.points));
+    parser.parallel(threads);
+    if (auto status = parser.tryParse(); !status)
+        parsed.error = status.error().message;
+    return parsed;
+}
+
+bool same(const Parsed &a, const Parsed &b) {
+    if (!a.error.empty() || !b.error.empty())
+        return a.error == b.error;
+    return a.ids == b.ids && a.coords == b.coords && a.tags == b.tags && a.points == b.points &&
+           a.verbose == b.verbose;
+}
+
+test::Argv sample(size_t n) {
+    test::Argv argv;
+    for (size_t i = 0; i < n; i++) {
+        argv.push(to_string(i));
+        switch (i % 8) {
+            case 0: argv.push("--id=" + to_string(i * 7)); break;
+            case 1: argv.push("-i" + to_string(i)); break;
+            case 2: argv.push("-vc").push("1.5").push(to_string(i)).push("-2e3"); break;
+            case 3: argv.push("--tag").push("t" + to_string(i % 5)); break;
+            case 4: argv.push("--coord").push("0").push(to_string(i) + ".25").push("1"); break;
+        }
+    }
+    return argv;
+}
+
+void testEquivalent() {
+    // Deferred conversions produce the same values as converting in place
+    for (size_t n : {0, 10, 100000}) {
+        test::Argv argv = sample(n);
+        Parsed serial = parse(argv, 1);
+        CHECK(serial.points.size() == n);
+        for (size_t threads : {2, 4, 0})
+            CHECK(same(parse(argv, threads), serial));
+    }
+}
+
+void testErrors() {
+    // The first invalid value is reported, even when classified after a later error
+    constexpr size_t n = 100000;
+    struct {
+        size_t at;
+        const char *token;
+    } cases[] = {
+        {10, "--id=x"},
+        {n / 2, "-ix"},
+        {n - 1, "nan?"},
+        {n / 3, "--coord"},
+        {n / 4, "--bogus"},
+    };
+    for (auto [at, token] : cases) {
+        test::Argv argv = sample(n);
+        char **tokens = argv.argv();
+        test::Argv bad;
+        for (int i = 1; i < argv.argc(); i++)
+            bad.push(i == int(at) ? token : tokens[i]);
+        bad.push("--unknown");
+        Parsed serial = parse(bad, 1);
+        CHECK(!serial.error.empty());
+        CHECK(same(parse(bad, 4), serial));
+    }
+}
+
+} // namespace
+
+int main() {
+    return test::run(testEquivalent, testErrors);
+}
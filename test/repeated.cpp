@@ -0,0 +1,121 @@
+//
+//  repeated.cpp
+//  Repeated value tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+using Ints = vector<int>;
+
+// Argv holding `tokens`
+test::Argv make(initializer_list<const char *> tokens) {
+    test::Argv argv;
+    for (const char *token : tokens)
+        argv.push(token);
+    return argv;
+}
+
+// Add repeated params with defaults to `parser`
+void schema(clip::Parser &parser) {
+    parser.add(clip::Opt<Ints>("inc").shortname('i').value({1, 2}));
+    parser.add(clip::Opt<Ints>("pair").nargs(2).value({8, 9}));
+    parser.add(clip::Opt<clip::Set<int>>("set").value({5}));
+    parser.add(clip::Arg<Ints>("rest").optional(true).value({7}));
+}
+
+void testArgv() {
+    // Parsed elements replace the default when parsing argv (serially or in parallel)
+    for (size_t threads : {1, 4}) {
+        test::Argv argv = make({"--inc", "3", "-i4", "--pair", "1", "2", "--set=6", "10", "11"});
+        clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+        schema(parser);
+        parser.parallel(threads);
+        CHECK(parser.tryParse());
+        CHECK(parser.getOpt<Ints>("inc").value() == Ints({3, 4}));
+        CHECK(parser.getOpt<Ints>("pair").value() == Ints({1, 2}));
+        CHECK(parser.getOpt<clip::Set<int>>("set").value() == clip::Set<int>({6}));
+        CHECK(parser.getArg<Ints>("rest").value() == Ints({10, 11}));
+    }
+}
+
+void testSource() {
+    // ... as when parsing any other source
+    vector<string> tokens = {"--inc", "3", "--pair", "1", "2", "10"};
+    clip::Parser parser{clip::App("test")};
+    schema(parser);
+    clip::RangeSource source(tokens.begin(), tokens.end());
+    CHECK(parser.tryParse(source));
+    CHECK(parser.getOpt<Ints>("inc").value() == Ints({3}));
+    CHECK(parser.getOpt<Ints>("pair").value() == Ints({1, 2}));
+    CHECK(parser.getOpt<clip::Set<int>>("set").value() == clip::Set<int>({5}));
+    CHECK(parser.getArg<Ints>("rest").value() == Ints({10}));
+}
+
+void testResult() {
+    // ... as when parsing into a separate result, reused across parses
+    clip::Parser parser{clip::App("test")};
+    schema(parser);
+    parser.freeze();
+    clip::Result result(parser);
+    for (int i = 0; i < 2; i++) {
+        vector<string> tokens = {"-i3", "--set", "4", "--set", "4", "10"};
+        clip::RangeSource source(tokens.begin(), tokens.end());
+        CHECK(parser.tryParse(source, result));
+        CHECK(result.value<Ints>("inc") == Ints({3}));
+        CHECK(result.value<Ints>("pair") == Ints({8, 9}));
+        CHECK(result.value<clip::Set<int>>("set") == clip::Set<int>({4}));
+        CHECK(result.value<Ints>("rest") == Ints({10}));
+    }
+}
+
+void testDefault() {
+    // Unmatched values keep their default, including after an earlier parse replaced it
+    clip::Parser parser{clip::App("test")};
+    schema(parser);
+    const vector<vector<string>> parses = {{"--inc=3", "10"}, {"--pair", "3", "4", "12"}};
+    for (const auto &tokens : parses) {
+        clip::RangeSource source(tokens.begin(), tokens.end());
+        CHECK(parser.tryParse(source));
+    }
+    CHECK(parser.getOpt<Ints>("inc").value() == Ints({1, 2}));
+    CHECK(parser.getOpt<Ints>("pair").value() == Ints({3, 4}));
+    CHECK(parser.getArg<Ints>("rest").value() == Ints({12}));
+}
+
+void testNargs() {
+    // Multiple values per occurrence cannot be optional, whichever is set first
+    auto rejected = [](auto build) {
+        try {
+            build();
+        } catch (const invalid_argument &) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(rejected([] { clip::Opt<Ints>("pair").nargs(2).optional(true); }));
+    CHECK(rejected([] { clip::Opt<Ints>("pair").optional(true).nargs(2); }));
+    CHECK(rejected([] { clip::Opt<int>("pair").nargs(2); }));
+    CHECK(!rejected([] { clip::Opt<Ints>("pair").nargs(2).optional(false); }));
+}
+
+} // namespace
+
+int main() {
+    return test::run(testArgv, testSource, testResult, testDefault, testNargs);
+}
@@ -0,0 +1,200 @@
+//
+//  reuse.cpp
+//  Parser reuse tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+using Ints = vector<int>;
+
+// Parser of sources, with a param of each kind
+struct Daemon {
+    clip::Parser parser{clip::App("daemon")};
+    int bound = 0;
+
+    Daemon() {
+        parser.add(clip::Flag("verbose").shortname('v'));
+        parser.add(clip::Opt<int>("num").shortname('n').value(1).bind(&this->bound));
+        parser.add(clip::Opt<Ints>("list").shortname('l').value({1, 2}));
+        parser.add(clip::Opt<clip::Set<string>>("tag").shortname('t'));
+        parser.add(clip::Arg<int>("arg"));
+    }
+
+    // Status of parsing `tokens`
+    clip::Expected<void> parse(initializer_list<const char *> tokens) {
+        vector<string> v(tokens.begin(), tokens.end());
+        clip::RangeSource source(v.begin(), v.end());
+        return this->parser.tryParse(source);
+    }
+
+    // Error of parsing `tokens` (empty on success)
+    string fail(initializer_list<const char *> tokens) {
+        auto status = this->parse(tokens);
+        return status ? string() : status.error().message;
+    }
+
+    // Check every param holds its default
+    bool defaults() const {
+        return this->parser.getFlag("verbose").count() == 0 &&
+               this->parser.getOpt<int>("num").value() == 1 &&
+               this->parser.getOpt<Ints>("list").value() == Ints({1, 2}) &&
+               this->parser.getOpt<clip::Set<string>>("tag").value().empty();
+    }
+};
+
+void testReparse() {
+    // Each parse starts from the defaults, rather than accumulating onto the last
+    Daemon daemon;
+    CHECK(daemon.fail({"-vv", "-n5", "-l3", "-l4", "-tb", "-ta", "7"}).empty());
+    CHECK(daemon.parser.getFlag("verbose").count() == 2);
+    CHECK(daemon.parser.getOpt<int>("num").value() == 5);
+    CHECK(daemon.parser.getOpt<Ints>("list").value() == Ints({3, 4}));
+    CHECK(daemon.parser.getOpt<clip::Set<string>>("tag").value() == clip::Set<string>({"a", "b"}));
+    CHECK(daemon.parser.getArg<int>("arg").value() == 7);
+    CHECK(daemon.bound == 5);
+    CHECK(daemon.fail({"-v", "-l5", "8"}).empty());
+    CHECK(daemon.parser.getFlag("verbose").count() == 1);
+    CHECK(daemon.parser.getOpt<int>("num").value() == 1);
+    CHECK(daemon.parser.getOpt<Ints>("list").value() == Ints({5}));
+    CHECK(daemon.parser.getOpt<clip::Set<string>>("tag").value().empty());
+    CHECK(daemon.parser.getArg<int>("arg").value() == 8);
+    CHECK(daemon.bound == 1);
+}
+
+void testReset() {
+    // Resetting restores the defaults (and is harmless before any parse, or repeated)
+    Daemon daemon;
+    daemon.parser.reset();
+    CHECK(daemon.fail({"-v", "-n5", "-l3", "-ta", "7"}).empty());
+    CHECK(!daemon.defaults());
+    daemon.parser.reset();
+    CHECK(daemon.defaults());
+    daemon.parser.reset();
+    CHECK(daemon.defaults());
+}
+
+void testErrors() {
+    // Errors are returned rather than exiting, leaving nothing behind for the next parse
+    Daemon daemon;
+    auto status = daemon.parse({"-v", "-n5", "-l3", "--bogus"});
+    CHECK(!status && status.error().code == clip::Errc::Unknown);
+    CHECK(daemon.fail({"-l3", "-n", "x", "7"}) == "invalid value for `-n=x`");
+    CHECK(daemon.fail({"7"}).empty());
+    CHECK(daemon.defaults());
+    CHECK(daemon.parser.getArg<int>("arg").value() == 7);
+    // ... including help and missing arguments, which are reported in their place
+    status = daemon.parse({"-v", "--help"});
+    CHECK(!status && status.error().code == clip::Errc::Help && status.error().status() == 0);
+    status = daemon.parse({});
+    CHECK(!status && status.error().code == clip::Errc::Missing);
+    CHECK(daemon.fail({"-t", "c", "8"}).empty());
+    CHECK(daemon.parser.getFlag("verbose").count() == 0);
+}
+
+void testCommands() {
+    // The selected subcommand follows each parse
+    clip::Parser parser{clip::App("daemon")};
+    parser.add(clip::Flag("verbose").shortname('v'));
+    parser.command("run", "Run it.", [](clip::Parser &run) {
+        run.add(clip::Flag("fast").shortname('f'));
+    });
+    parser.command("stop", "Stop it.", [](clip::Parser &stop) {
+        stop.add(clip::Opt<int>("after").value(0));
+    });
+    auto parse = [&](vector<string> tokens) {
+        clip::RangeSource source(tokens.begin(), tokens.end());
+        return bool(parser.tryParse(source));
+    };
+    CHECK(parse({"-v", "run", "-ff"}));
+    CHECK(parser.command() && parser.command()->getFlag("fast").count() == 2);
+    CHECK(parse({"stop", "--after", "3"}));
+    CHECK(parser.getFlag("verbose").count() == 0);
+    CHECK(parser.command() && parser.command()->getOpt<int>("after").value() == 3);
+    CHECK(parse({"run"}));
+    CHECK(parser.command() && parser.command()->getFlag("fast").count() == 0);
+}
+
+void testThreads() {
+    // Results are parsed into concurrently from a shared parser, each seeing only its own tokens
+    Daemon daemon;
+    daemon.parser.freeze();
+    const clip::Parser &parser = daemon.parser;
+    constexpr size_t n = 8;
+    vector<char> ok(n); // not `vector<bool>`, whose elements share words
+    vector<thread> threads;
+    for (size_t i = 0; i < n; i++) {
+        threads.emplace_back([&, i] {
+            clip::Result result(parser);
+            bool same = true;
+            for (int j = 0; j < 1000; j++) {
+                string num = to_string(i * j);
+                vector<string> tokens = {"-n", num, "-l" + to_string(i), to_string(j)};
+                if (i % 2)
+                    tokens.push_back("-v");
+                clip::RangeSource source(tokens.begin(), tokens.end());
+                same &= bool(parser.tryParse(source, result)) &&
+                        result.value<int>("num") == int(i * j) &&
+                        result.value<Ints>("list") == Ints({int(i)}) &&
+                        result.value<int>("arg") == j && result.count("verbose") == i % 2;
+            }
+            ok[i] = same;
+        });
+    }
+    for (thread &t : threads)
+        t.join();
+    for (size_t i = 0; i < n; i++)
+        CHECK(ok[i]);
+}
+
+void testStale() {
+    // Results from before the parser was laid out afresh are rejected, rather than misread
+    Daemon daemon;
+    daemon.parser.freeze();
+    clip::Result result(daemon.parser);
+    vector<string> tokens = {"-n", "5", "7"};
+    clip::RangeSource source(tokens.begin(), tokens.end());
+    CHECK(daemon.parser.tryParse(source, result));
+    daemon.parser.add(clip::Opt<string>("name").value("x"));
+    daemon.parser.freeze();
+    auto rejected = [](auto read) {
+        try {
+            read();
+        } catch (const logic_error &) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(rejected([&] { result.value<int>("num"); }));
+    CHECK(rejected([&] { result.count("verbose"); }));
+    CHECK(rejected([&] { result.reset(); }));
+    clip::RangeSource again(tokens.begin(), tokens.end());
+    CHECK(rejected([&] { daemon.parser.tryParse(again, result); }));
+    // ... while new results see the new layout
+    clip::Result fresh(daemon.parser);
+    clip::RangeSource next(tokens.begin(), tokens.end());
+    CHECK(daemon.parser.tryParse(next, fresh));
+    CHECK(fresh.value<int>("num") == 5 && fresh.value<string>("name") == "x");
+}
+
+} // namespace
+
+int main() {
+    return test::run(testReparse, testReset, testErrors, testCommands, testThreads, testStale);
+}
@@ -0,0 +1,167 @@
+//
+//  schema.cpp
+//  Compile-time schema tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <array>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+constexpr auto SCHEMA = clip::schema([] {
+    return std::array{
+        clip::Spec::flag("verbose").shortname('v').help("Set verbosity level."),
+        clip::Spec::opt<int>("num").shortname('n').help("Sample integer."),
+        clip::Spec::opt("name").longname("label").help("Sample string."),
+        clip::Spec::opt<int>("level").shortname('l').optional(true),
+        clip::Spec::arg<double>("delay").help("Sample positional."),
+    };
+});
+
+constexpr size_t VERBOSE = SCHEMA.index("verbose");
+constexpr size_t NUM = SCHEMA.index("num");
+constexpr size_t NAME = SCHEMA.index("name");
+constexpr size_t LEVEL = SCHEMA.index("level");
+constexpr size_t DELAY = SCHEMA.index("delay");
+
+const clip::App APP = clip::App("test").version("1.0");
+
+// Argv of `tokens`
+test::Argv argv(initializer_list<string> tokens) {
+    test::Argv argv;
+    for (const string &token : tokens)
+        argv.push(token);
+    return argv;
+}
+
+// Error from parsing `tokens` against the schema (empty on success)
+string fail(initializer_list<string> tokens) {
+    test::Argv args = argv(tokens);
+    auto matches = SCHEMA.tryParse(APP, args.argc(), args.argv());
+    return matches ? string() : matches.error().message;
+}
+
+// Error from parsing `tokens` with the equivalent runtime parser (empty on success)
+string expect(initializer_list<string> tokens) {
+    test::Argv args = argv(tokens);
+    clip::Parser parser(args.argc(), args.argv(), APP);
+    parser.add(clip::Flag("verbose").shortname('v').help("Set verbosity level."));
+    parser.add(clip::Opt<int>("num").shortname('n').help("Sample integer."));
+    parser.add(clip::Opt<string>("name").longname("label").help("Sample string."));
+    parser.add(clip::Opt<int>("level").shortname('l').optional(true));
+    parser.add(clip::Arg<double>("delay").help("Sample positional."));
+    auto status = parser.tryParse();
+    return status ? string() : status.error().message;
+}
+
+void testMatch() {
+    // Options and arguments are matched in any form, their values checked against their type
+    test::Argv args = argv({"-vv", "--num=3", "--label", "x", "-l", "2", "1.5"});
+    auto matches = SCHEMA.tryParse(APP, args.argc(), args.argv());
+    CHECK(matches);
+    if (!matches)
+        return;
+    CHECK(matches.value().count(VERBOSE) == 2);
+    CHECK(matches.value().get<int>(NUM) == 3);
+    CHECK(matches.value().value(NAME) == "x");
+    CHECK(matches.value().get<int>(LEVEL) == 2);
+    CHECK(matches.value().get<double>(DELAY) == 1.5);
+    // ... leaving optional values unset where the next string does not convert
+    args = argv({"-l", "-v", "1"});
+    matches = SCHEMA.tryParse(APP, args.argc(), args.argv());
+    CHECK(matches && matches.value().count(LEVEL) == 1 && matches.value().value(LEVEL).empty());
+    CHECK(matches && matches.value().count(VERBOSE) == 1);
+}
+
+void testErrors() {
+    // Errors are those of the equivalent parser
+    for (auto tokens : initializer_list<initializer_list<string>>{
+             {"--bogus", "1"},
+             {"-x", "1"},
+             {"--num"},
+             {"--num", "x", "1"},
+             {"-n=x", "1"},
+             {"--label=", "1"},
+             {"x"},
+             {"1", "2"},
+             {"-v"},
+             {"--", "-v"},
+             {"--level=x", "1"},
+         }) {
+        string error = fail(tokens);
+        CHECK(!error.empty());
+        CHECK(error == expect(tokens));
+    }
+}
+
+void testAutoflags() {
+    // Help and version are requested as from a parser, and no arguments at all request usage
+    auto code = [](initializer_list<string> tokens, const clip::App &app) {
+        test::Argv args = argv(tokens);
+        auto matches = SCHEMA.tryParse(app, args.argc(), args.argv());
+        return matches ? clip::Errc::Internal : matches.error().code;
+    };
+    CHECK(code({"--help"}, APP) == clip::Errc::Help);
+    CHECK(code({"1", "-vh"}, APP) == clip::Errc::Help);
+    CHECK(code({"-V"}, APP) == clip::Errc::Version);
+    CHECK(code({"--version"}, clip::App("test")) == clip::Errc::Unknown);
+    CHECK(code({}, APP) == clip::Errc::Missing);
+    constexpr auto flags = clip::schema([] {
+        return std::array{clip::Spec::flag("verbose"), clip::Spec::flag("help").shortname('x')};
+    });
+    test::Argv none;
+    auto matches = flags.tryParse(APP, none.argc(), none.argv());
+    CHECK(!matches && matches.error().code == clip::Errc::Usage);
+    // ... unless taken by the schema's own params
+    test::Argv help = argv({"--help", "-x"});
+    matches = flags.tryParse(APP, help.argc(), help.argv());
+    CHECK(matches && matches.value().count(flags.index("help")) == 2);
+}
+
+void testResponse() {
+    // Response files are expanded (their values outliving the parse), except after `--`
+    test::File file("schema.rsp", "--label 'a b' -n 4");
+    string at = "@" + file.path();
+    test::Argv args = argv({at, "2"});
+    auto matches = SCHEMA.tryParse(APP, args.argc(), args.argv());
+    CHECK(matches && matches.value().value(NAME) == "a b");
+    CHECK(matches && matches.value().get<int>(NUM) == 4);
+    CHECK(fail({"--", at}) == "invalid value for `delay`");
+}
+
+void testNames() {
+    // Names are validated as by a parser (failing to compile within a constant expression)
+    auto rejected = [](auto spec) {
+        try {
+            spec();
+        } catch (const invalid_argument &) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(rejected([] { clip::Spec::flag("bad name"); }));
+    CHECK(rejected([] { clip::Spec::opt("-num"); }));
+    CHECK(rejected([] { clip::Spec::flag("ok").longname(""); }));
+    CHECK(rejected([] { clip::Spec::flag("ok").shortname('-'); }));
+    CHECK(rejected([] { clip::Spec::arg("ok").shortname('o'); }));
+    CHECK(!rejected([] { clip::Spec::arg("any name"); }));
+}
+
+} // namespace
+
+int main() {
+    return test::run(testMatch, testErrors, testAutoflags, testResponse, testNames);
+}
@@ -0,0 +1,84 @@
+//
+//  stats.cpp
+//  Parse statistics tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+void testTrace() {
+    // A leading trace path is taken before parsing (and ignored without `CLIP_STATS`)
+    test::File file("stats.json", "");
+    test::Argv argv("tool");
+    argv.push("--clip-trace=" + file.path()).push("-v").push("1");
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("tool"));
+    parser.add(clip::Flag("verbose").shortname('v'));
+    parser.add(clip::Arg<int>("num"));
+    CHECK(parser.argc == 2);
+    CHECK(parser.tryParse());
+    CHECK(parser.getFlag("verbose").count() == 1);
+    CHECK(parser.getArg<int>("num").value() == 1);
+    // ... only in first place
+    test::Argv late("tool");
+    late.push("1").push("--clip-trace=" + file.path());
+    clip::Parser other(late.argc(), late.argv(), clip::App("tool"));
+    other.add(clip::Arg<int>("num"));
+    auto status = other.tryParse();
+    CHECK(!status && status.error().code == clip::Errc::Unknown);
+}
+
+void testConcurrent() {
+    // Statistics are read while results are parsed into from other threads
+    clip::Parser parser(clip::App("tool"));
+    parser.add(clip::Flag("verbose").shortname('v'));
+    parser.add(clip::Opt<int>("num").shortname('n'));
+    parser.freeze();
+    constexpr size_t n = 4, m = 1000;
+    vector<thread> threads;
+    for (size_t i = 0; i < n; i++) {
+        threads.emplace_back([&] {
+            clip::Result result(parser);
+            vector<string> tokens = {"-v", "-n", "3"};
+            for (size_t j = 0; j < m; j++) {
+                clip::RangeSource source(tokens.begin(), tokens.end());
+                parser.tryParse(source, result);
+            }
+        });
+    }
+    uint64_t tokens = 0;
+    bool monotonic = true;
+    for (size_t i = 0; i < m; i++) {
+        uint64_t next = parser.stats().tokens;
+        monotonic &= next >= tokens;
+        tokens = next;
+    }
+    for (thread &t : threads)
+        t.join();
+    CHECK(monotonic);
+#ifdef CLIP_STATS
+    CHECK(parser.stats().tokens == n * m * 3);
+#else
+    CHECK(parser.stats().tokens == 0);
+#endif
+}
+
+} // namespace
+
+int main() {
+    return test::run(testTrace, testConcurrent);
+}
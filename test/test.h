@@ -0,0 +1,114 @@
+//
+//  test.h
+//  Test harness.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#pragma once
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "hooks.h"
+
+// NOTE: includes the global allocation hooks, so this header must be included by exactly one
+//       translation unit per test binary.
+
+namespace test {
+
+using hooks::allocs;
+using hooks::Argv;
+
+// failed checks
+inline std::size_t failures = 0;
+
+// class File
+// Temporary file holding some text, removed once out of scope.
+class File final {
+private:
+    // impl members
+    std::string path_;
+
+public:
+    // ctors
+    File(const std::string &name, const std::string &text) : path_(File::at(name)) {
+        std::FILE *file = std::fopen(this->path_.data(), "w");
+        std::fwrite(text.data(), 1, text.size(), file);
+        std::fclose(file);
+    }
+    File(const File &) = delete;
+    File &operator=(const File &) = delete;
+
+    // dtor
+    ~File() {
+        std::remove(this->path_.data());
+    }
+
+    // accessors
+    const std::string &path() const {
+        return this->path_;
+    }
+
+    // accessors (static)
+    // Path of the file named `name` (whether or not created yet)
+    static std::string at(const std::string &name) {
+        return "/tmp/clip-" + std::to_string(::getpid()) + "-" + name;
+    }
+};
+
+// Count allocations made by `body()`
+template <typename Body>
+std::size_t allocations(Body body) {
+    std::size_t allocs0 = allocs;
+    body();
+    return allocs - allocs0;
+}
+
+// Report a check, returning whether it passed
+inline bool check(bool ok, const char *expr, const char *file, int line) {
+    if (!ok) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        failures++;
+    }
+    return ok;
+}
+
+// Check `body()` performs exactly `budget` allocations
+template <typename Body>
+bool budget(const char *name, std::size_t budget, Body body, const char *file, int line) {
+    std::size_t n = allocations(body);
+    if (n != budget) {
+        std::fprintf(stderr,
+                     "%s:%d: %s: %zu allocations (budget: %zu)\n",
+                     file,
+                     line,
+                     name,
+                     n,
+                     budget);
+        failures++;
+    }
+    return n == budget;
+}
+
+// Run each test, returning an exit status
+template <typename... Tests>
+int run(Tests... tests) {
+    (tests(), ...);
+    std::fprintf(stderr, "%s: %zu failed\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace test
+
+// Check a condition
+#define CHECK(expr) ::test::check(bool(expr), #expr, __FILE__, __LINE__)
+// Check the allocations made by a block of code
+#define BUDGET(name, n, ...) ::test::budget(name, n, [&] { __VA_ARGS__; }, __FILE__, __LINE__)
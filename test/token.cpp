@@ -0,0 +1,210 @@
+//
+//  token.cpp
+//  Token stream tests.
+//
+//  Created by agent on 2026-10-18.
+//  Copyright © 2026 Zakhary Kaplan. All rights reserved.
+//
+//  SPDX-License-Identifier: MIT
+//
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "clip/clip.h"
+#include "test.h"
+
+using namespace std;
+
+namespace {
+
+using Strings = vector<string>;
+
+using test::File;
+
+// Tokens read from `source`
+template <typename S>
+Strings read(S &source) {
+    Strings out;
+    string_view token;
+    while (source.next(token))
+        out.emplace_back(token);
+    return out;
+}
+
+// Tokens read from `tokens`, expanding response files (with any error appended)
+Strings expand(const Strings &tokens) {
+    test::Argv argv;
+    for (const string &token : tokens)
+        argv.push(token);
+    clip::ArgvSource source(argv.argc() - 1, argv.argv() + 1);
+    clip::Tokens stream(source);
+    Strings out = read(stream);
+    if (stream.error())
+        out.push_back("error: " + stream.error()->message);
+    return out;
+}
+
+void testQuoting() {
+    // Quotes group characters, with escapes removed outside single quotes
+    File file("quoting.rsp", "a  'b c'\t\"d\\\"e\"\n"
+                             "f\\ g \"h\\\\i\" 'j\\k' x'y'\"z\" ''\n");
+    Strings tokens = expand({"@" + file.path()});
+    CHECK(tokens == Strings({"a", "b c", "d\"e", "f g", "h\\i", "j\\k", "xyz", ""}));
+    // ... unless raw, which only finds token boundaries
+    clip::FileSource raw(file.path().data(), true);
+    CHECK(read(raw) == Strings({"a", "'b c'", "\"d\\\"e\"", "f\\ g", "\"h\\\\i\"", "'j\\k'",
+                                "x'y'\"z\"", "''"}));
+}
+
+void testNested() {
+    // Response files are expanded in place, including within other response files
+    File inner("inner.rsp", "c d");
+    File outer("outer.rsp", "b @" + inner.path() + " e");
+    CHECK(expand({"a", "@" + outer.path(), "f"}) == Strings({"a", "b", "c", "d", "e", "f"}));
+    // ... as is the same file more than once, so long as it does not include itself
+    CHECK(expand({"@" + inner.path(), "@" + inner.path()}) == Strings({"c", "d", "c", "d"}));
+    // Files that cannot be opened, and a bare `@`, are passed through
+    CHECK(expand({"@/nonexistent/clip.rsp", "@"}) == Strings({"@/nonexistent/clip.rsp", "@"}));
+    // Empty files expand to nothing
+    File empty("empty.rsp", "");
+    CHECK(expand({"a", "@" + empty.path(), "b"}) == Strings({"a", "b"}));
+}
+
+void testCycles() {
+    // Files including themselves end the stream with an error
+    File a("a.rsp", "w @" + File::at("b.rsp"));
+    File b("b.rsp", "x @" + a.path());
+    CHECK(expand({"@" + a.path(), "z"}) ==
+          Strings({"w", "x", "error: response file includes itself: `@" + a.path() + "`"}));
+    File self("self.rsp", "@" + File::at("self.rsp"));
+    CHECK(expand({"@" + self.path()}) ==
+          Strings({"error: response file includes itself: `@" + self.path() + "`"}));
+}
+
+void testDepth() {
+    // Nesting is limited to `DEPTH` files
+    auto chain = [](size_t depth) {
+        vector<unique_ptr<File>> files;
+        files.push_back(make_unique<File>("depth-0.rsp", "end"));
+        for (size_t i = 1; i < depth; i++) {
+            string name = "depth-" + to_string(i) + ".rsp";
+            files.push_back(make_unique<File>(name, "@" + files.back()->path()));
+        }
+        return expand({"@" + files.back()->path()});
+    };
+    CHECK(chain(clip::Tokens::DEPTH) == Strings({"end"}));
+    Strings deep = chain(clip::Tokens::DEPTH + 1);
+    CHECK(deep.size() == 1 && deep[0].starts_with("error: response files nested too deeply"));
+}
+
+void testTerminator() {
+    // Response files after `--` are taken literally
+    File file("terminator.rsp", "--num 2");
+    test::Argv argv;
+    for (const string &token : Strings{"@" + file.path(), "--", "@" + file.path()})
+        argv.push(token);
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    parser.add(clip::Opt<int>("num"));
+    parser.add(clip::Arg<string>("rest"));
+    parser.parse();
+    CHECK(parser.getOpt<int>("num").value() == 2);
+    CHECK(parser.getArg<string>("rest").value() == "@" + file.path());
+}
+
+// Tokens of `text` read from a buffer
+Strings buffer(const string &text, char delim) {
+    clip::BufferSource source(text, delim);
+    return read(source);
+}
+
+// Tokens of `text` read incrementally from a file descriptor
+Strings fd(const string &text, char delim) {
+    File file("fd.txt", text);
+    int fd = ::open(file.path().data(), O_RDONLY | O_CLOEXEC);
+    clip::FdSource source(fd, delim);
+    Strings tokens = read(source);
+    ::close(fd);
+    return tokens;
+}
+
+void testDelimited() {
+    // Delimiters end each token, so only a trailing delimiter produces no empty token
+    using namespace string_literals;
+    for (auto split : {buffer, fd}) {
+        CHECK(split("", '\0').empty());
+        CHECK(split("a\0b\0"s, '\0') == Strings({"a", "b"}));
+        CHECK(split("a\0b"s, '\0') == Strings({"a", "b"}));
+        CHECK(split("\0a\0\0b\0"s, '\0') == Strings({"", "a", "", "b"}));
+        CHECK(split("\0"s, '\0') == Strings({""}));
+        CHECK(split("a b\n\nc\n", '\n') == Strings({"a b", "", "c"}));
+    }
+}
+
+void testChunks() {
+    // Tokens are assembled across reads, each remaining valid while the next is read
+    const string large(clip::FdSource::CHUNK + 7, 'x');
+    File file("chunks.txt", "a\n" + large + "\nb\n" + large);
+    int fd = ::open(file.path().data(), O_RDONLY | O_CLOEXEC);
+    clip::FdSource source(fd, '\n');
+    Strings tokens;
+    string_view token, prev;
+    while (source.next(token)) {
+        if (!tokens.empty())
+            CHECK(prev == tokens.back());
+        tokens.emplace_back(token);
+        prev = token;
+    }
+    ::close(fd);
+    CHECK(tokens == Strings({"a", large, "b", large}));
+}
+
+void testParse() {
+    // Parsers read delimited sources as they would argv
+    using namespace string_literals;
+    File file("parse.txt", "--num\0003\0a b\0"s);
+    int fd = ::open(file.path().data(), O_RDONLY | O_CLOEXEC);
+    clip::FdSource source(fd);
+    test::Argv argv;
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    parser.add(clip::Opt<int>("num"));
+    parser.add(clip::Arg<string>("rest"));
+    parser.parse(source);
+    ::close(fd);
+    CHECK(parser.getOpt<int>("num").value() == 3);
+    CHECK(parser.getArg<string>("rest").value() == "a b");
+}
+
+void testKeys() {
+    // Errors name short options whose token has since been replaced by later values
+    using namespace string_literals;
+    File file("keys.txt", "-p\0001\00022\000x\0"s);
+    int fd = ::open(file.path().data(), O_RDONLY | O_CLOEXEC);
+    clip::FdSource source(fd);
+    test::Argv argv;
+    clip::Parser parser(argv.argc(), argv.argv(), clip::App("test"));
+    parser.add(clip::Opt<vector<int>>("pos").shortname('p').nargs(3));
+    auto status = parser.tryParse(source);
+    ::close(fd);
+    CHECK(!status && status.error().message == "invalid value for `-p=x`");
+}
+
+} // namespace
+
+int main() {
+    return test::run(testQuoting,
+                     testNested,
+                     testCycles,
+                     testDepth,
+                     testTerminator,
+                     testDelimited,
+                     testChunks,
+                     testParse,
+                     testKeys);
+}